@@ -0,0 +1,116 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <vector>
+#include "../src/automata.hpp"
+#include "../src/jobs.hpp"
+#include "../src/random.hpp"
+#include "bench.hpp"
+
+
+// one cell per byte, the textbook way, as the reference
+static void lifeReference(std::vector<Uint8>& cells, int width, int height) {
+    std::vector<Uint8> next(cells.size());
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int count = 0;
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    if (dx == 0 && dy == 0) continue;
+                    count += cells[((y + dy + height) % height) * width + (x + dx + width) % width];
+                }
+            }
+            const Uint8 alive = cells[y * width + x];
+            next[y * width + x] = count == 3 || (alive && count == 2);
+        }
+    }
+    cells.swap(next);
+}
+
+static bool lifeMatches(const Life& life, const std::vector<Uint8>& cells) {
+    for (int y = 0; y < life.height(); y++) {
+        for (int x = 0; x < life.width(); x++) {
+            if (life.get(x, y) != (cells[y * life.width() + x] != 0)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+BENCHMARK(automata) {
+    const AutomataPath paths[] = { AUTOMATA_GENERIC, AUTOMATA_AVX2 };
+    JobSystem jobs;
+    char name[64];
+
+    // correctness on a small torus, both paths, serial and banded
+    for (AutomataPath path : paths) {
+        if (path == AUTOMATA_AVX2 && automataBestPath() != AUTOMATA_AVX2) continue;
+        Rng rng(2178);
+        Life life(192, 100);
+        life.randomize(rng, 0.3f);
+        std::vector<Uint8> cells(192 * 100);
+        for (int y = 0; y < 100; y++) {
+            for (int x = 0; x < 192; x++) {
+                cells[y * 192 + x] = life.get(x, y);
+            }
+        }
+        for (int g = 0; g < 100; g++) {
+            if (g % 2 == 0) {
+                life.step(path);
+            } else {
+                life.step(jobs, path);
+            }
+            lifeReference(cells, 192, 100);
+        }
+        if (!lifeMatches(life, cells)) {
+            snprintf(name, sizeof(name), "automata: life (%s) differs from the reference", automataPathName(path));
+            benchError(name);
+        }
+    }
+
+    // the 4096x4096 torus
+    const int side = 4096;
+    const double cells = (double)side * side;
+    Rng rng(2178);
+    Life life(side, side);
+    for (AutomataPath path : paths) {
+        if (path == AUTOMATA_AVX2 && automataBestPath() != AUTOMATA_AVX2) continue;
+        life.randomize(rng);
+        double rate = opsPerSecond([&]() { life.step(path); });
+        snprintf(name, sizeof(name), "automata/life/%d/%s", side, automataPathName(path));
+        benchReport(name, rate * cells, "cells/s");
+        life.randomize(rng);
+        rate = opsPerSecond([&]() { life.step(jobs, path); });
+        snprintf(name, sizeof(name), "automata/life/%d/%s/threads%d", side, automataPathName(path), jobs.threadCount());
+        benchReport(name, rate * cells, "cells/s");
+    }
+
+    // every elementary rule against the textbook version
+    const int width = 640;
+    for (int rule = 0; rule < 256; rule++) {
+        Wolfram ca(width, (Uint8)rule);
+        std::vector<Uint8> ref(width, 0), next(width);
+        ref[width / 2] = 1;
+        for (int g = 0; g < 100; g++) {
+            ca.step();
+            for (int x = 0; x < width; x++) {
+                const int l = ref[(x + width - 1) % width];
+                const int c = ref[x];
+                const int r = ref[(x + 1) % width];
+                next[x] = (rule >> (l * 4 + c * 2 + r)) & 1;
+            }
+            ref.swap(next);
+        }
+        for (int x = 0; x < width; x++) {
+            if (ca.get(x) != (ref[x] != 0)) {
+                snprintf(name, sizeof(name), "automata: wolfram rule %d differs from the reference", rule);
+                benchError(name);
+                break;
+            }
+        }
+    }
+    Wolfram ca(side, 110);
+    double rate = opsPerSecond([&]() { ca.step(); });
+    snprintf(name, sizeof(name), "automata/wolfram110/%d", side);
+    benchReport(name, rate * side, "cells/s");
+}
@@ -0,0 +1,89 @@
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "../src/barneshut.hpp"
+#include "../src/jobs.hpp"
+#include "../src/random.hpp"
+#include "bench.hpp"
+
+
+// a disc of bodies with a few heavy ones, like the attraction sketches
+static void makeBodies(int count, std::vector<float>& x, std::vector<float>& y, std::vector<float>& mass) {
+    Rng rng(2178);
+    x.resize(count);
+    y.resize(count);
+    mass.resize(count);
+    for (int i = 0; i < count; i++) {
+        const float angle = rng.uniform() * 6.2831853f;
+        const float r = 1000 * sqrtf(rng.uniform());
+        x[i] = 1000 + r * cosf(angle);
+        y[i] = 1000 + r * sinf(angle);
+        mass[i] = (i % 100 == 0) ? 100.0f : 1.0f + rng.uniform();
+    }
+}
+
+// relative RMS error of the force vectors against the reference
+static double forceError(const std::vector<float>& fx, const std::vector<float>& fy,
+                         const std::vector<float>& ref_x, const std::vector<float>& ref_y) {
+    double error = 0;
+    double norm = 0;
+    for (size_t i = 0; i < fx.size(); i++) {
+        error += (fx[i] - ref_x[i]) * (double)(fx[i] - ref_x[i]) + (fy[i] - ref_y[i]) * (double)(fy[i] - ref_y[i]);
+        norm += ref_x[i] * (double)ref_x[i] + ref_y[i] * (double)ref_y[i];
+    }
+    return sqrt(error / norm);
+}
+
+
+BENCHMARK(barnes_hut) {
+    const int counts[] = { 10000, 100000, 1000000 };
+    const float thetas[] = { 0.3f, 0.5f, 0.8f, 1.0f };
+    JobSystem jobs;
+    char name[64];
+
+    for (int count : counts) {
+        std::vector<float> x, y, mass;
+        makeBodies(count, x, y, mass);
+        std::vector<float> fx(count), fy(count);
+        BarnesHut tree(0.5f);
+
+        double build = opsPerSecond([&]() {
+            tree.build(x.data(), y.data(), mass.data(), count);
+        }, 0.3);
+        snprintf(name, sizeof(name), "barnes_hut/%d/build", count);
+        benchReport(name, build, "builds/s");
+        double serial = opsPerSecond([&]() {
+            tree.forces(x.data(), y.data(), mass.data(), fx.data(), fy.data(), count);
+        }, 0.3);
+        snprintf(name, sizeof(name), "barnes_hut/%d/forces", count);
+        benchReport(name, serial * count, "bodies/s");
+        double parallel = opsPerSecond([&]() {
+            tree.forces(x.data(), y.data(), mass.data(), fx.data(), fy.data(), count, jobs);
+        }, 0.3);
+        snprintf(name, sizeof(name), "barnes_hut/%d/forces_threads%d", count, jobs.threadCount());
+        benchReport(name, parallel * count, "bodies/s");
+
+        if (count > 10000) {
+            continue;
+        }
+        // accuracy against the direct sum
+        std::vector<float> ref_x(count), ref_y(count);
+        double brute = opsPerSecond([&]() {
+            bruteForceForces(x.data(), y.data(), mass.data(), ref_x.data(), ref_y.data(), count);
+        }, 0.3);
+        snprintf(name, sizeof(name), "barnes_hut/%d/brute", count);
+        benchReport(name, brute * count, "bodies/s");
+        for (float theta : thetas) {
+            tree.setTheta(theta);
+            tree.forces(x.data(), y.data(), mass.data(), fx.data(), fy.data(), count, jobs);
+            const double error = forceError(fx, fy, ref_x, ref_y);
+            snprintf(name, sizeof(name), "barnes_hut/%d/error_theta%.1f", count, theta);
+            benchReport(name, error * 100, "% rms");
+            // the bound the header promises
+            if (theta <= 0.5f && error > 0.01) {
+                benchError("Barnes-Hut error above 1% at theta 0.5");
+            }
+        }
+    }
+}
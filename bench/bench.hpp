@@ -0,0 +1,50 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <vector>
+
+
+// Benchmarks register themselves with BENCHMARK(name) { ... } and are run
+// by bench_main.cpp (all of them, or those whose name contains a filter).
+// Each measurement is reported with benchReport(): a table on stdout,
+// plus one json line per result when run with --json, e.g.
+//   {"tag":"1a2b3c4","bench":"noise/batch/avx2","value":5.2e7,"unit":"samples/s"}
+typedef void (*BenchFn)();
+int registerBench(const char* name, BenchFn fn);
+
+#define BENCHMARK(name) \
+    static void bench_##name(); \
+    static int bench_registered_##name = registerBench(#name, bench_##name); \
+    static void bench_##name()
+
+void benchReport(const char* name, double value, const char* unit);
+// mark the run as failed (e.g. a result mismatch); the suite exits non-zero
+void benchError(const char* message);
+
+// the renderer's target as RGBA32 bytes, for comparing frames
+inline std::vector<Uint8> benchReadPixels(SDL_Renderer* renderer, int width, int height) {
+    std::vector<Uint8> pixels(width * height * 4);
+    SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_RGBA32, pixels.data(), width * 4);
+    return pixels;
+}
+
+
+// call `fn` repeatedly for at least `minSeconds` and return calls per second
+template <typename F>
+double opsPerSecond(F fn, double minSeconds = 0.5) {
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    const Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 now = start;
+    long calls = 0;
+    long batch = 1;
+    while ((double)(now - start) / freq < minSeconds) {
+        for (long i = 0; i < batch; i++) {
+            fn();
+        }
+        calls += batch;
+        if (batch < (1 << 20)) batch *= 2;
+        now = SDL_GetPerformanceCounter();
+    }
+    return calls / ((double)(now - start) / freq);
+}
@@ -0,0 +1,98 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+
+struct Bench {
+    const char* name;
+    BenchFn fn;
+};
+
+// function-local so registration works whatever order files initialize in
+static std::vector<Bench>& registry() {
+    static std::vector<Bench> benches;
+    return benches;
+}
+
+static FILE* gJson = NULL;
+static std::string gTag;
+static bool gFailed = false;
+
+
+int registerBench(const char* name, BenchFn fn) {
+    registry().push_back({ name, fn });
+    return (int)registry().size();
+}
+
+void benchReport(const char* name, double value, const char* unit) {
+    printf("%-40s %14.2f %s\n", name, value, unit);
+    fflush(stdout);
+    if (gJson != NULL) {
+        fprintf(gJson, "{\"tag\":\"%s\",\"bench\":\"%s\",\"value\":%.6g,\"unit\":\"%s\"}\n",
+                gTag.c_str(), name, value, unit);
+        fflush(gJson);
+    }
+}
+
+void benchError(const char* message) {
+    printf("Error: %s\n", message);
+    gFailed = true;
+}
+
+
+int main( int argc, char* args[] )
+{
+    std::vector<std::string> filters;
+    std::string json_path;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = args[i];
+        if (arg == "--json" && i + 1 < argc) {
+            json_path = args[++i];
+        } else if (arg == "--tag" && i + 1 < argc) {
+            gTag = args[++i];
+        } else if (arg == "--list") {
+            for (const Bench& bench : registry()) {
+                printf("%s\n", bench.name);
+            }
+            return 0;
+        } else if (arg[0] == '-') {
+            printf("Usage: %s [--list] [--json results.jsonl] [--tag label] [filter...]\n", args[0]);
+            return 1;
+        } else {
+            filters.push_back(arg);
+        }
+    }
+    if (!json_path.empty()) {
+        // appended, so one file can collect runs from many commits
+        gJson = fopen(json_path.c_str(), "a");
+        if (gJson == NULL) {
+            printf("Error: Unable to open %s\n", json_path.c_str());
+            return 1;
+        }
+    }
+
+    std::vector<Bench> benches = registry();
+    std::sort(benches.begin(), benches.end(), [](const Bench& a, const Bench& b) {
+        return strcmp(a.name, b.name) < 0;
+    });
+    for (const Bench& bench : benches) {
+        bool selected = filters.empty();
+        for (const std::string& filter : filters) {
+            if (strstr(bench.name, filter.c_str()) != NULL) {
+                selected = true;
+            }
+        }
+        if (selected) {
+            bench.fn();
+        }
+    }
+
+    if (gJson != NULL) {
+        fclose(gJson);
+    }
+    return gFailed ? 1 : 0;
+}
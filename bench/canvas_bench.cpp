@@ -0,0 +1,120 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "../src/utils.hpp"
+#include "../src/canvas.hpp"
+#include "../src/jobs.hpp"
+#include "../src/noise.hpp"
+#include "bench.hpp"
+
+
+// a full-window grayscale noise field, one pixel at a time through the
+// renderer vs. written into a PixelCanvas
+BENCHMARK(canvas) {
+    const int width = 640;
+    const int height = 480;
+    const float scale = 0.01f;
+    char name[64];
+
+    SDLWindow window;
+    if (!window.init(width, height, false, BACKEND_HEADLESS)) {
+        benchError("headless window could not be created");
+        return;
+    }
+    SDL_Renderer* renderer = window.getRenderer();
+    NoiseLattice lattice(2178);
+    Noise noise(lattice);
+    JobSystem jobs;
+
+    // the noise is the same every frame, so only drawing is measured
+    std::vector<Uint8> gray(width * height);
+    std::vector<float> xs(width);
+    for (int x = 0; x < width; x++) {
+        xs[x] = x * scale;
+    }
+    for (int y = 0; y < height; y++) {
+        std::vector<float> ys(width, y * scale);
+        std::vector<float> out(width);
+        noise.sampleBatch(xs.data(), ys.data(), NULL, out.data(), width);
+        for (int x = 0; x < width; x++) {
+            gray[y * width + x] = (Uint8)(out[x] * 255);
+        }
+    }
+
+    double rate = opsPerSecond([&]() {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                const Uint8 g = gray[y * width + x];
+                Point(x, y, { g, g, g, 255 }).draw(renderer);
+            }
+        }
+        SDL_RenderPresent(renderer);
+    });
+    benchReport("canvas/640x480/points", rate, "frames/s");
+    const std::vector<Uint8> expected = benchReadPixels(renderer, width, height);
+
+    PixelCanvas canvas;
+    if (!canvas.init(renderer, width, height)) {
+        benchError("canvas: texture could not be created");
+        return;
+    }
+    auto fill = [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            Uint32* row = canvas.bandRow(y);
+            const Uint8* src = &gray[y * width];
+            for (int x = 0; x < width; x++) {
+                row[x] = PixelCanvas::pack(src[x], src[x], src[x]);
+            }
+        }
+    };
+    rate = opsPerSecond([&]() {
+        canvas.pixels(); // fill doesn't mark the canvas, fillRows does
+        fill(0, height);
+        canvas.present();
+        SDL_RenderPresent(renderer);
+    });
+    benchReport("canvas/640x480/canvas", rate, "frames/s");
+    if (benchReadPixels(renderer, width, height) != expected) {
+        benchError("canvas: canvas frame differs from drawing points");
+    }
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0xFF);
+    SDL_RenderClear(renderer);
+    rate = opsPerSecond([&]() {
+        canvas.fillRows(jobs, fill);
+        canvas.present();
+        SDL_RenderPresent(renderer);
+    });
+    snprintf(name, sizeof(name), "canvas/640x480/canvas_threads%d", jobs.threadCount());
+    benchReport(name, rate, "frames/s");
+    if (benchReadPixels(renderer, width, height) != expected) {
+        benchError("canvas: parallel canvas frame differs from drawing points");
+    }
+
+    // sampling the noise per frame too, the way an animated field would
+    float z = 0;
+    rate = opsPerSecond([&]() {
+        canvas.fillRows(jobs, [&](int begin, int end) {
+            std::vector<float> ys(width);
+            std::vector<float> zs(width, z);
+            std::vector<float> out(width);
+            for (int y = begin; y < end; y++) {
+                std::fill(ys.begin(), ys.end(), y * scale);
+                noise.sampleBatch(xs.data(), ys.data(), zs.data(), out.data(), width);
+                Uint32* row = canvas.bandRow(y);
+                for (int x = 0; x < width; x++) {
+                    const Uint8 g = (Uint8)(out[x] * 255);
+                    row[x] = PixelCanvas::pack(g, g, g);
+                }
+            }
+        });
+        z += 0.01f;
+        canvas.present();
+        SDL_RenderPresent(renderer);
+    });
+    snprintf(name, sizeof(name), "canvas/640x480/noise_field_threads%d", jobs.threadCount());
+    benchReport(name, rate, "frames/s");
+    canvas.close();
+    window.close();
+}
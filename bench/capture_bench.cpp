@@ -0,0 +1,59 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <string>
+#include "../src/utils.hpp"
+#include "../src/capture.hpp"
+#include "bench.hpp"
+
+
+// headless 1080p frames with a few circles on them, captured blocking so
+// the rate is what the writer sustains end to end
+BENCHMARK(capture) {
+    const int width = 1920;
+    const int height = 1080;
+    const int frames = 120;
+    const char* paths[] = { "capture_bench.rgba", "capture_bench.y4m", "capture_bench.ppm" };
+    char name[64];
+
+    SDLWindow window;
+    if (!window.init(width, height, false, BACKEND_HEADLESS)) {
+        benchError("headless window could not be created");
+        return;
+    }
+    SDL_Renderer* renderer = window.getRenderer();
+    Circle circle(0, height / 2, 100, SDL_COL_RED, true);
+
+    for (const char* path : paths) {
+        FrameCapture capture;
+        const CaptureFormat format = captureFormatFromPath(path);
+        if (!capture.open(path, format, width, height, 60, true)) {
+            benchError("capture could not be opened");
+            return;
+        }
+        const Uint64 start = SDL_GetPerformanceCounter();
+        for (int i = 0; i < frames; i++) {
+            SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+            SDL_RenderClear(renderer);
+            circle.move(i * 16, circle.y());
+            circle.draw(renderer);
+            capture.capture(renderer);
+            SDL_RenderPresent(renderer);
+        }
+        capture.close();
+        const double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+        snprintf(name, sizeof(name), "capture/1080p/%s", path + 14);
+        benchReport(name, capture.written() / seconds, "frames/s");
+
+        // clean up what was written
+        if (format == CAPTURE_PPM) {
+            for (int i = 0; i < frames; i++) {
+                snprintf(name, sizeof(name), "capture_bench_%05d.ppm", i);
+                remove(name);
+            }
+        } else {
+            remove(path);
+        }
+    }
+
+    window.close();
+}
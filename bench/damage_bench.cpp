@@ -0,0 +1,112 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <vector>
+#include "../src/utils.hpp"
+#include "../src/damage.hpp"
+#include "../src/particles.hpp"
+#include "../src/trails.hpp"
+#include "bench.hpp"
+
+
+// the fun_with_shapes scene (a few shapes crossing a big window), redrawn
+// in full every frame vs. only the damaged regions
+struct ShapesScene {
+    ParticleSystem circles;
+    Rectangle rect = Rectangle(0, 240, 80, 80, SDL_COL_BLUE, false);
+    int width;
+    int height;
+    ShapesScene(int w, int h) : width(w), height(h) {
+        circles.add(0, h / 2, 3, 0, 100, SDL_COL_RED);
+        circles.add(0, h / 2, 4, 0, 50, SDL_COL_GREEN);
+        rect.move(0, h / 2);
+    }
+    void tick() {
+        circles.integrate(1, INTEGRATE_SEMI_IMPLICIT);
+        circles.constrain(BOUNDARY_WRAP, width, height);
+        rect.move(rect.x() + 2 >= width ? -rect.width() : rect.x() + 2, rect.y());
+    }
+    void draw(SDL_Renderer* renderer) {
+        circles.draw(renderer);
+        rect.draw(renderer);
+    }
+};
+
+BENCHMARK(damage) {
+    const int sizes[][2] = { { 640, 480 }, { 3840, 2160 } };
+    const int frames = 300;
+    char name[64];
+
+    for (const int* size : sizes) {
+        const int width = size[0];
+        const int height = size[1];
+        SDLWindow window;
+        if (!window.init(width, height, false, BACKEND_HEADLESS)) {
+            benchError("headless window could not be created");
+            return;
+        }
+        SDL_Renderer* renderer = window.getRenderer();
+        const Uint64 freq = SDL_GetPerformanceFrequency();
+
+        // full: clear and draw everything
+        ShapesScene full(width, height);
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int f = 0; f < frames; f++) {
+            full.tick();
+            SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+            SDL_RenderClear(renderer);
+            full.draw(renderer);
+            SDL_RenderPresent(renderer);
+        }
+        double seconds = (double)(SDL_GetPerformanceCounter() - start) / freq;
+        snprintf(name, sizeof(name), "damage/%dx%d/full", width, height);
+        benchReport(name, frames / seconds, "frames/s");
+        const std::vector<Uint8> expected = benchReadPixels(renderer, width, height);
+
+        // dirty, straight into the framebuffer (it keeps its pixels)
+        ShapesScene dirty(width, height);
+        DamageTracker damage(width, height);
+        SDL_Rect rect_drawn = dirty.rect.bounds();
+        start = SDL_GetPerformanceCounter();
+        for (int f = 0; f < frames; f++) {
+            dirty.tick();
+            dirty.circles.damage(damage);
+            damage.moved(rect_drawn, dirty.rect.bounds());
+            rect_drawn = dirty.rect.bounds();
+            damage.redraw(renderer, SDL_COL_WHITE, [&]() { dirty.draw(renderer); });
+            SDL_RenderPresent(renderer);
+        }
+        seconds = (double)(SDL_GetPerformanceCounter() - start) / freq;
+        snprintf(name, sizeof(name), "damage/%dx%d/dirty", width, height);
+        benchReport(name, frames / seconds, "frames/s");
+        if (benchReadPixels(renderer, width, height) != expected) {
+            benchError("damage: dirty frame differs from the full redraw");
+        }
+
+        // dirty into a scene buffer, copied to the window every frame (what
+        // windowed sketches do); only checked, the copy's cost is the GPU's
+        ShapesScene buffered(width, height);
+        DamageTracker buffered_damage(width, height);
+        TrailBuffer scene;
+        if (!scene.init(renderer, width, height, SDL_COL_WHITE)) {
+            benchError("damage: scene buffer could not be created");
+            return;
+        }
+        rect_drawn = buffered.rect.bounds();
+        for (int f = 0; f < frames; f++) {
+            buffered.tick();
+            buffered.circles.damage(buffered_damage);
+            buffered_damage.moved(rect_drawn, buffered.rect.bounds());
+            rect_drawn = buffered.rect.bounds();
+            scene.begin();
+            buffered_damage.redraw(renderer, SDL_COL_WHITE, [&]() { buffered.draw(renderer); });
+            scene.end();
+            scene.present();
+            SDL_RenderPresent(renderer);
+        }
+        if (benchReadPixels(renderer, width, height) != expected) {
+            benchError("damage: buffered dirty frame differs from the full redraw");
+        }
+        scene.close();
+        window.close();
+    }
+}
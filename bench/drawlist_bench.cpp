@@ -0,0 +1,85 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "../src/utils.hpp"
+#include "../src/drawlist.hpp"
+#include "../src/random.hpp"
+#include "bench.hpp"
+
+
+// many small circles in interleaved colors, drawn shape by shape vs through a DrawList
+BENCHMARK(drawlist) {
+    const int width = 640;
+    const int height = 480;
+    const int counts[] = { 1000, 10000 };
+    const SDL_Color palette[] = {
+        { 255, 0, 0, 160 }, { 0, 255, 0, 160 }, { 0, 0, 255, 160 }, { 255, 255, 0, 160 },
+        { 255, 0, 255, 160 }, { 0, 255, 255, 160 }, { 0, 0, 0, 160 }, { 128, 128, 128, 160 }
+    };
+    char name[64];
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    if (renderer == NULL) {
+        benchError("software renderer could not be created");
+        return;
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    std::vector<Uint32> immediate_pixels(width * height);
+    std::vector<Uint32> list_pixels(width * height);
+
+    for (int count : counts) {
+        Rng rng(2178);
+        std::vector<Circle> circles;
+        for (int i = 0; i < count; i++) {
+            circles.push_back(Circle(rng.below(width), rng.below(height), 2 + rng.below(7),
+                                     palette[i % 8], i % 3 != 0));
+        }
+        DrawList list;
+
+        // same picture either way
+        SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+        SDL_RenderClear(renderer);
+        for (Circle& circle : circles) {
+            circle.draw(renderer);
+        }
+        SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, immediate_pixels.data(), width * 4);
+        SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+        SDL_RenderClear(renderer);
+        for (Circle& circle : circles) {
+            circle.record(list);
+        }
+        list.flush(renderer);
+        SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, list_pixels.data(), width * 4);
+        if (memcmp(immediate_pixels.data(), list_pixels.data(), list_pixels.size() * 4) != 0) {
+            benchError("draw list output differs from immediate drawing");
+        }
+        const DrawStats stats = list.lastStats();
+
+        double immediate = opsPerSecond([&]() {
+            for (Circle& circle : circles) {
+                circle.draw(renderer);
+            }
+        });
+        double listed = opsPerSecond([&]() {
+            for (Circle& circle : circles) {
+                circle.record(list);
+            }
+            list.flush(renderer);
+        });
+        snprintf(name, sizeof(name), "drawlist/%d/immediate_calls", count);
+        benchReport(name, count, "calls/frame");
+        snprintf(name, sizeof(name), "drawlist/%d/list_calls", count);
+        benchReport(name, stats.drawCalls, "calls/frame");
+        snprintf(name, sizeof(name), "drawlist/%d/list_state_changes", count);
+        benchReport(name, stats.stateChanges, "changes/frame");
+        snprintf(name, sizeof(name), "drawlist/%d/immediate", count);
+        benchReport(name, immediate, "frames/s");
+        snprintf(name, sizeof(name), "drawlist/%d/list", count);
+        benchReport(name, listed, "frames/s");
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+}
@@ -0,0 +1,100 @@
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "../src/utils.hpp"
+#include "../src/flowfield.hpp"
+#include "../src/noise.hpp"
+#include "../src/particles.hpp"
+#include "../src/random.hpp"
+#include "bench.hpp"
+
+
+BENCHMARK(flowfield) {
+    const int count = 100000;
+    const float width = 1920;
+    const float height = 1080;
+    const float cell = 20;
+    const float scale = 0.005f;
+    const float turns = 2;
+    const float max_speed = 2;
+    const float max_force = 0.1f;
+    char name[64];
+
+    NoiseLattice lattice(2178);
+    Noise noise(lattice);
+    Rng rng(2178);
+    ParticleSystem agents;
+    agents.reserve(count);
+    for (int i = 0; i < count; i++) {
+        agents.add(rng.uniform() * width, rng.uniform() * height, 0, 0, 2, SDL_COL_BLACK);
+    }
+    FlowField flow(width, height, cell, noise);
+    flow.setNoise(noise, scale, turns);
+
+    double rate = opsPerSecond([&]() { flow.bake(0); });
+    snprintf(name, sizeof(name), "flowfield/bake/%dx%d", flow.columns() + 1, flow.rows() + 1);
+    benchReport(name, 1000 / rate, "ms");
+
+    // what every agent sampling noise at its own position costs
+    std::vector<float> xs(count), ys(count), zs(count), angles(count);
+    float t = 0;
+    rate = opsPerSecond([&]() {
+        const float* x = agents.x();
+        const float* y = agents.y();
+        const float* vx = agents.vx();
+        const float* vy = agents.vy();
+        float* ax = agents.ax();
+        float* ay = agents.ay();
+        for (int i = 0; i < count; i++) {
+            xs[i] = x[i] * scale;
+            ys[i] = y[i] * scale;
+            zs[i] = t;
+        }
+        noise.sampleBatch(xs.data(), ys.data(), zs.data(), angles.data(), count);
+        for (int i = 0; i < count; i++) {
+            const float a = angles[i] * turns * 2 * (float)M_PI;
+            const Vec2 force = (Vec2(cosf(a), sinf(a)) * max_speed - Vec2(vx[i], vy[i])).limited(max_force);
+            ax[i] += force.x;
+            ay[i] += force.y;
+        }
+        agents.integrate(1, INTEGRATE_SEMI_IMPLICIT);
+        agents.constrain(BOUNDARY_WRAP, width, height);
+        t += 0.001f;
+    }, 1.0);
+    snprintf(name, sizeof(name), "flowfield/agents/%dk/noise_per_agent", count / 1000);
+    benchReport(name, 1000 / rate, "ms/tick");
+
+    // the baked field, refreshed an eighth at a time
+    const int rows_per_tick = (flow.rows() + 1 + 7) / 8;
+    rate = opsPerSecond([&]() {
+        flow.refresh(t, rows_per_tick);
+        flow.steer(agents.x(), agents.y(), agents.vx(), agents.vy(), agents.ax(), agents.ay(),
+                   count, max_speed, max_force);
+        agents.integrate(1, INTEGRATE_SEMI_IMPLICIT);
+        agents.constrain(BOUNDARY_WRAP, width, height);
+        t += 0.001f;
+    }, 1.0);
+    snprintf(name, sizeof(name), "flowfield/agents/%dk/field_refresh8", count / 1000);
+    benchReport(name, 1000 / rate, "ms/tick");
+
+    // how far the bilinear lookup strays from sampling the noise directly
+    flow.bake(0);
+    double error = 0;
+    const int samples = 10000;
+    for (int i = 0; i < samples; i++) {
+        const float x = rng.uniform() * width;
+        const float y = rng.uniform() * height;
+        const float a = noise.sample(x * scale, y * scale, 0) * turns * 2 * (float)M_PI;
+        error += (flow.lookup(x, y) - Vec2(cosf(a), sinf(a))).length();
+    }
+    snprintf(name, sizeof(name), "flowfield/lookup_error/cell%d", (int)cell);
+    benchReport(name, error / samples, "mean |d|");
+    // at the nodes the lookup is the baked sample itself
+    const float nx = 7 * cell;
+    const float ny = 3 * cell;
+    const float na = noise.sample(nx * scale, ny * scale, 0) * turns * 2 * (float)M_PI;
+    if ((flow.lookup(nx, ny) - Vec2(cosf(na), sinf(na))).length() > 1e-5f) {
+        benchError("flowfield: lookup at a node differs from the noise there");
+    }
+}
@@ -0,0 +1,71 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <vector>
+#include "../src/utils.hpp"
+#include "../src/jobs.hpp"
+#include "../src/particles.hpp"
+#include "../src/walker.hpp"
+#include "bench.hpp"
+
+
+// whole frames (update + clear + draw + present) on the headless backend
+BENCHMARK(frames) {
+    const int width = 640;
+    const int height = 480;
+    const int counts[] = { 1000, 10000 };
+    char name[64];
+
+    SDLWindow window;
+    if (!window.init(width, height, false, BACKEND_HEADLESS)) {
+        benchError("headless window could not be created");
+        return;
+    }
+    SDL_Renderer* renderer = window.getRenderer();
+    JobSystem jobs;
+
+    for (int count : counts) {
+        // moving circles, cleared every frame
+        Rng rng(2178);
+        ParticleSystem particles;
+        particles.reserve(count);
+        for (int i = 0; i < count; i++) {
+            const SDL_Color color = { (Uint8)rng.below(256), (Uint8)rng.below(256), (Uint8)rng.below(256), 255 };
+            particles.add(rng.uniform() * width, rng.uniform() * height,
+                          rng.uniform() * 4 - 2, rng.uniform() * 4 - 2, 2 + rng.below(6), color);
+        }
+        double rate = opsPerSecond([&]() {
+            particles.update(1, jobs);
+            particles.wrap(width, height, jobs);
+            SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+            SDL_RenderClear(renderer);
+            particles.draw(renderer);
+            SDL_RenderPresent(renderer);
+        });
+        snprintf(name, sizeof(name), "frames/particles/%d", count);
+        benchReport(name, rate, "frames/s");
+
+        // walkers leaving trails, like the walker sketch
+        NoiseLattice lattice(2178);
+        std::vector<RandomWalker> walkers;
+        walkers.reserve(count);
+        for (int i = 0; i < count; i++) {
+            walkers.push_back(RandomWalker(width / 2, height / 2, SDL_COL_RED, height, width,
+                                           Noise(lattice, i), rng.split()));
+            walkers.back().setMode((StepMode)(i % 3), i % 3 == STEP_PERLIN ? 0.005f : 2);
+        }
+        rate = opsPerSecond([&]() {
+            jobs.parallelFor(0, count, 1024, [&](int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    walkers[i].update();
+                }
+            });
+            for (RandomWalker& walker : walkers) {
+                walker.draw(renderer);
+            }
+            SDL_RenderPresent(renderer);
+        });
+        snprintf(name, sizeof(name), "frames/walkers/%d", count);
+        benchReport(name, rate, "frames/s");
+    }
+    window.close();
+}
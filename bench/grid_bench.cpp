@@ -0,0 +1,90 @@
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdio.h>
+#include <atomic>
+#include <vector>
+#include "../src/grid.hpp"
+#include "../src/jobs.hpp"
+#include "../src/random.hpp"
+#include "bench.hpp"
+
+
+// neighbors within radius for every entity, the inner loop of flocking/collisions
+static long neighborPairs(const SpatialGrid& grid, const float* x, const float* y, int count,
+                          float radius, JobSystem& jobs) {
+    std::atomic<long> total(0);
+    jobs.parallelFor(0, count, 4096, [&](int begin, int end) {
+        std::vector<int> found;
+        long pairs = 0;
+        for (int i = begin; i < end; i++) {
+            found.clear();
+            pairs += grid.queryRadius(x[i], y[i], radius, found);
+        }
+        total += pairs;
+    });
+    return total;
+}
+
+BENCHMARK(grid) {
+    const int counts[] = { 10000, 100000, 1000000 };
+    const float radius = 20;
+    JobSystem jobs;
+    char name[64];
+
+    for (int count : counts) {
+        // about one entity per 100 square pixels, whatever the count
+        const float side = sqrtf((float)count) * 10;
+        Rng rng(2178);
+        std::vector<float> x(count), y(count), vx(count), vy(count);
+        for (int i = 0; i < count; i++) {
+            x[i] = rng.uniform() * side;
+            y[i] = rng.uniform() * side;
+            vx[i] = rng.uniform() * 2 - 1;
+            vy[i] = rng.uniform() * 2 - 1;
+        }
+        SpatialGrid grid(side, side, radius);
+        grid.rebuild(x.data(), y.data(), count);
+
+        double moved = opsPerSecond([&]() {
+            for (int i = 0; i < count; i++) {
+                x[i] += vx[i];
+                y[i] += vy[i];
+            }
+            grid.rebuild(x.data(), y.data(), count);
+        }, 0.3);
+        snprintf(name, sizeof(name), "grid/%d/rebuild_moving", count);
+        benchReport(name, moved, "rebuilds/s");
+        double still = opsPerSecond([&]() {
+            grid.rebuild(x.data(), y.data(), count);
+        }, 0.3);
+        snprintf(name, sizeof(name), "grid/%d/rebuild_still", count);
+        benchReport(name, still, "rebuilds/s");
+
+        long pairs = 0;
+        double queries = opsPerSecond([&]() {
+            pairs = neighborPairs(grid, x.data(), y.data(), count, radius, jobs);
+        }, 0.3);
+        snprintf(name, sizeof(name), "grid/%d/query_all", count);
+        benchReport(name, queries * count, "queries/s");
+
+        if (count <= 10000) {
+            // O(n^2) reference: same pairs, much slower
+            long brute_pairs = 0;
+            double brute = opsPerSecond([&]() {
+                brute_pairs = 0;
+                for (int i = 0; i < count; i++) {
+                    for (int j = 0; j < count; j++) {
+                        const float dx = x[j] - x[i];
+                        const float dy = y[j] - y[i];
+                        brute_pairs += (dx * dx + dy * dy <= radius * radius);
+                    }
+                }
+            }, 0.3);
+            if (brute_pairs != pairs) {
+                benchError("grid neighbor count differs from brute force");
+            }
+            snprintf(name, sizeof(name), "grid/%d/query_all_brute", count);
+            benchReport(name, brute * count, "queries/s");
+        }
+    }
+}
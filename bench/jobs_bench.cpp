@@ -0,0 +1,59 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "../src/jobs.hpp"
+#include "../src/noise.hpp"
+#include "../src/particles.hpp"
+#include "../src/utils.hpp"
+#include "bench.hpp"
+
+
+BENCHMARK(jobs) {
+    const int count = 1 << 20;
+    NoiseLattice lattice(2178);
+    Noise noise(lattice);
+    std::vector<float> t(count), out(count), expected(count);
+    ParticleSystem particles;
+    char name[64];
+
+    particles.reserve(count);
+    for (int i = 0; i < count; i++) {
+        t[i] = i * 0.001f;
+        particles.add(i % 640, i % 480, 1, -1, 2, SDL_COL_RED);
+    }
+    noise.sampleBatch(t.data(), NULL, NULL, expected.data(), count);
+
+    const int max_threads = (int)std::thread::hardware_concurrency();
+    double base = 0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        JobSystem jobs(threads);
+
+        // walker-style noise sampling, one batch per chunk
+        auto sample = [&](int begin, int end) {
+            noise.sampleBatch(t.data() + begin, NULL, NULL, out.data() + begin, end - begin);
+        };
+        jobs.parallelFor(0, count, 4096, sample);
+        if (memcmp(out.data(), expected.data(), count * sizeof(float)) != 0) {
+            benchError("parallel noise differs from serial");
+            return;
+        }
+        double rate = opsPerSecond([&]() {
+            jobs.parallelFor(0, count, 4096, sample);
+        }) * count;
+        if (threads == 1) base = rate;
+        snprintf(name, sizeof(name), "jobs/noise/threads%d", threads);
+        benchReport(name, rate, "samples/s");
+        snprintf(name, sizeof(name), "jobs/noise/threads%d/speedup", threads);
+        benchReport(name, rate / base, "x");
+
+        // bulk movement + wraparound
+        rate = opsPerSecond([&]() {
+            particles.update(1, jobs);
+            particles.wrap(640, 480, jobs);
+        }) * count;
+        snprintf(name, sizeof(name), "jobs/particles/threads%d", threads);
+        benchReport(name, rate, "particles/s");
+    }
+}
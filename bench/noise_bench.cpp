@@ -0,0 +1,52 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "../src/noise.hpp"
+#include "bench.hpp"
+
+
+BENCHMARK(noise) {
+    const int count = 4096;
+    NoiseLattice lattice(2178);
+    Noise noise(lattice, 7);
+    std::vector<float> x(count), y(count), z(count);
+    std::vector<float> expected(count), out(count);
+    char name[64];
+
+    srand(2178);
+    // walker-like coordinates: a slow drift plus some spread
+    for (int i = 0; i < count; i++) {
+        x[i] = 0.01f + i * 0.005f;
+        y[i] = (float)rand() / RAND_MAX * 100.0f - 50.0f;
+        z[i] = (float)rand() / RAND_MAX * 10.0f;
+    }
+
+    noise.sampleBatch(x.data(), y.data(), z.data(), expected.data(), count, NOISE_SCALAR);
+
+    const NoisePath paths[] = { NOISE_SCALAR, NOISE_SSE2, NOISE_AVX2 };
+    for (NoisePath path : paths) {
+        if (path > noiseBestPath()) {
+            printf("noise/batch/%s skipped (not supported by this cpu)\n", noisePathName(path));
+            continue;
+        }
+        noise.sampleBatch(x.data(), y.data(), z.data(), out.data(), count, path);
+        if (memcmp(out.data(), expected.data(), count * sizeof(float)) != 0) {
+            benchError("noise SIMD results differ from the scalar path");
+            return;
+        }
+        double rate = opsPerSecond([&]() {
+            noise.sampleBatch(x.data(), y.data(), z.data(), out.data(), count, path);
+        });
+        snprintf(name, sizeof(name), "noise/batch/%s", noisePathName(path));
+        benchReport(name, rate * count, "samples/s");
+    }
+
+    // what spawning a walker costs now that the lattice is shared
+    double spawns = opsPerSecond([&]() {
+        Noise handle(lattice, (unsigned int)rand());
+        out[0] = handle.sample(0.5f);
+    });
+    benchReport("noise/handle/create+sample", spawns, "handles/s");
+}
@@ -0,0 +1,64 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include "../src/utils.hpp"
+#include "../src/particles.hpp"
+#include "../src/jobs.hpp"
+#include "../src/random.hpp"
+#include "bench.hpp"
+
+
+// a full tick for a million movers: gravity, drag, integrate, bounce
+BENCHMARK(physics) {
+    const int count = 1000000;
+    const Integrator integrators[] = { INTEGRATE_EULER, INTEGRATE_SEMI_IMPLICIT, INTEGRATE_VERLET };
+    const char* names[] = { "euler", "semi_implicit", "verlet" };
+    JobSystem jobs;
+    char name[64];
+
+    Rng rng(2178);
+    ParticleSystem movers;
+    movers.reserve(count);
+    for (int i = 0; i < count; i++) {
+        movers.add(rng.uniform() * 1920, rng.uniform() * 1080, rng.uniform() * 8 - 4, rng.uniform() * 8 - 4,
+                   2, SDL_COL_RED, 1 + rng.uniform());
+    }
+
+    for (int k = 0; k < 3; k++) {
+        double serial = opsPerSecond([&]() {
+            movers.applyAcceleration(0, 0.1f);
+            movers.applyDrag(0.001f);
+            movers.integrate(1, integrators[k]);
+            movers.constrain(BOUNDARY_BOUNCE, 1920, 1080, 0.9f);
+        }, 0.3);
+        snprintf(name, sizeof(name), "physics/1M/%s", names[k]);
+        benchReport(name, 1000.0 / serial, "ms/tick");
+        double parallel = opsPerSecond([&]() {
+            movers.applyAcceleration(0, 0.1f);
+            movers.applyDrag(0.001f);
+            movers.integrate(1, integrators[k], jobs);
+            movers.constrain(BOUNDARY_BOUNCE, 1920, 1080, 0.9f, jobs);
+        }, 0.3);
+        snprintf(name, sizeof(name), "physics/1M/%s/threads%d", names[k], jobs.threadCount());
+        benchReport(name, 1000.0 / parallel, "ms/tick");
+    }
+
+    // nothing escapes a bounce
+    const float* x = movers.x();
+    const float* y = movers.y();
+    for (int i = 0; i < count; i++) {
+        if (x[i] < 2 || x[i] > 1918 || y[i] < 2 || y[i] > 1078) {
+            benchError("mover left the bounce boundary");
+            break;
+        }
+    }
+
+    const Boundary boundaries[] = { BOUNDARY_WRAP, BOUNDARY_CLAMP };
+    const char* boundary_names[] = { "wrap", "clamp" };
+    for (int b = 0; b < 2; b++) {
+        double rate = opsPerSecond([&]() {
+            movers.constrain(boundaries[b], 1920, 1080, 1.0f);
+        }, 0.3);
+        snprintf(name, sizeof(name), "physics/1M/constrain_%s", boundary_names[b]);
+        benchReport(name, 1000.0 / rate, "ms/tick");
+    }
+}
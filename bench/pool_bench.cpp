@@ -0,0 +1,135 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+#include <vector>
+#include "../src/utils.hpp"
+#include "../src/arena.hpp"
+#include "../src/particles.hpp"
+#include "../src/pool.hpp"
+#include "../src/random.hpp"
+#include "bench.hpp"
+
+
+// every heap allocation in the bench binary goes through here, so a
+// steady-state loop can check it made none
+static std::atomic<long> g_allocations(0);
+
+void* operator new(size_t bytes) {
+    g_allocations++;
+    void* p = malloc(bytes ? bytes : 1);
+    if (p == NULL) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+// not inlined, so gcc doesn't see free() paired with operator new at the
+// call sites (-Wmismatched-new-delete); they are a matched pair here
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    free(p);
+}
+
+// sized delete frees the same way, through the unsized one
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+
+BENCHMARK(pool) {
+    const int count = 100000;
+    const int churn = 1000; // particles killed and respawned every tick
+    const int ticks = 600;
+    Rng rng(2178);
+    char name[64];
+
+    // a fountain: particles die at random and are replaced at the emitter
+    ParticleSystem particles;
+    particles.reserve(count);
+    for (int i = 0; i < count; i++) {
+        particles.spawn(rng.uniform() * 1920, rng.uniform() * 1080,
+                        rng.uniform() * 2 - 1, rng.uniform() * 2 - 1, 2, SDL_COL_RED);
+    }
+    FrameArena arena(64 << 10);
+    Handle last_killed;
+    auto tick = [&]() {
+        // per-frame scratch comes from the arena
+        Handle* dying = arena.alloc<Handle>(churn);
+        for (int i = 0; i < churn; i++) {
+            dying[i] = particles.handle(rng.below(particles.size()));
+        }
+        for (int i = 0; i < churn; i++) {
+            // a particle can be picked twice, the second kill is a no-op
+            if (particles.kill(dying[i])) {
+                last_killed = dying[i];
+            }
+        }
+        while (particles.size() < count) {
+            particles.spawn(960, 1000, rng.uniform() * 4 - 2, -4 - rng.uniform() * 4, 2, SDL_COL_RED);
+        }
+        particles.applyAcceleration(0, 0.1f);
+        particles.integrate(1, INTEGRATE_SEMI_IMPLICIT);
+        particles.constrain(BOUNDARY_BOUNCE, 1920, 1080, 0.9f);
+        arena.reset();
+    };
+
+    // warm up, then count what a steady run allocates
+    for (int t = 0; t < 60; t++) {
+        tick();
+    }
+    const long before = g_allocations;
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    const Uint64 start = SDL_GetPerformanceCounter();
+    for (int t = 0; t < ticks; t++) {
+        tick();
+    }
+    const double seconds = (double)(SDL_GetPerformanceCounter() - start) / freq;
+    const long allocations = g_allocations - before;
+    snprintf(name, sizeof(name), "pool/particles/%dk/churn%d", count / 1000, churn);
+    benchReport(name, seconds * 1000 / ticks, "ms/tick");
+    benchReport("pool/particles/steady_allocations", (double)allocations, "allocs");
+    if (allocations != 0) {
+        benchError("pool: steady-state ticks allocated");
+    }
+
+    // every live handle still finds its particle, dead ones find nothing
+    for (int i = 0; i < particles.size(); i++) {
+        if (particles.indexOf(particles.handle(i)) != i) {
+            benchError("pool: handle lookup mismatch");
+            break;
+        }
+    }
+    if (particles.alive(last_killed)) {
+        benchError("pool: killed handle still alive");
+    }
+
+    // spawn + kill one object: pooled vs a new/delete per object
+    const int live = 10000;
+    Pool<Circle> pool;
+    pool.reserve(live);
+    std::vector<Handle> handles(live);
+    for (int i = 0; i < live; i++) {
+        handles[i] = pool.spawn(Circle(0, 0, 2, SDL_COL_RED));
+    }
+    double pooled = opsPerSecond([&]() {
+        const int i = rng.below(live);
+        pool.kill(handles[i]);
+        handles[i] = pool.spawn(Circle(0, 0, 2, SDL_COL_RED));
+    });
+    benchReport("pool/circles/pool_spawn_kill", pooled, "ops/s");
+
+    std::vector<Circle*> objects(live);
+    for (int i = 0; i < live; i++) {
+        objects[i] = new Circle(0, 0, 2, SDL_COL_RED);
+    }
+    double heap = opsPerSecond([&]() {
+        const int i = rng.below(live);
+        delete objects[i];
+        objects[i] = new Circle(0, 0, 2, SDL_COL_RED);
+    });
+    benchReport("pool/circles/new_delete", heap, "ops/s");
+    for (Circle* c : objects) {
+        delete c;
+    }
+}
@@ -0,0 +1,69 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "../src/random.hpp"
+#include "bench.hpp"
+
+
+BENCHMARK(random) {
+    const int count = 4096;
+    std::vector<int> dx(count), dy(count);
+    volatile int sink = 0;
+
+    // the old walker step: global rand() and an if/else chain
+    srand(2178);
+    double legacy = opsPerSecond([&]() {
+        int x = 0, y = 0;
+        for (int i = 0; i < count; i++) {
+            int choice = rand() % 8;
+            if (choice == 0) {
+                x++;
+            } else if (choice == 1) {
+                x--;
+            } else if (choice == 2) {
+                y++;
+            } else if (choice == 3) {
+                y--;
+            } else if (choice == 4) {
+                x++; y++;
+            } else if (choice == 5) {
+                x--; y++;
+            } else if (choice == 6) {
+                x++; y--;
+            } else {
+                x--; y--;
+            }
+        }
+        sink = x + y;
+    });
+    benchReport("random/step8/rand", legacy * count, "steps/s");
+
+    Rng rng(2178);
+    double single = opsPerSecond([&]() {
+        int x = 0, y = 0;
+        for (int i = 0; i < count; i++) {
+            const int* d = DIRECTIONS8[rng.next() >> 61];
+            x += d[0];
+            y += d[1];
+        }
+        sink = x + y;
+    });
+    benchReport("random/step8/rng", single * count, "steps/s");
+
+    double bulk = opsPerSecond([&]() {
+        fillDirections(rng, 8, dx.data(), dy.data(), count);
+    });
+    benchReport("random/step8/fill_directions", bulk * count, "steps/s");
+
+    double bulk4 = opsPerSecond([&]() {
+        fillDirections(rng, 4, dx.data(), dy.data(), count);
+    });
+    benchReport("random/step4/fill_directions", bulk4 * count, "steps/s");
+
+    double streams = opsPerSecond([&]() {
+        Rng child = rng.split();
+        sink = (int)child.next();
+    });
+    benchReport("random/split", streams, "streams/s");
+}
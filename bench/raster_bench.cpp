@@ -0,0 +1,113 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "../src/utils.hpp"
+#include "../src/drawlist.hpp"
+#include "../src/jobs.hpp"
+#include "../src/random.hpp"
+#include "../src/raster.hpp"
+#include "bench.hpp"
+
+
+// records the scene: translucent and opaque shapes of every kind, some
+// hanging off the edges, and a few in the other blend modes
+static void recordScene(std::vector<Circle>& circles, std::vector<Rectangle>& rectangles,
+                        std::vector<Point>& points, DrawList& list) {
+    for (size_t i = 0; i < circles.size(); i++) {
+        if (i % 50 == 0) list.setBlendMode(i % 100 == 0 ? SDL_BLENDMODE_ADD : SDL_BLENDMODE_MOD);
+        circles[i].record(list);
+        rectangles[i].record(list);
+        points[i].record(list);
+        if (i % 50 == 0) list.setBlendMode(SDL_BLENDMODE_BLEND);
+    }
+}
+
+// the same shapes through flush() to the software renderer vs. binned into tiles
+BENCHMARK(raster) {
+    struct Case { int width; int height; int count; int size; };
+    const Case cases[] = { { 640, 480, 10000, 8 }, { 1920, 1080, 10000, 40 } };
+    const SDL_Color palette[] = {
+        { 255, 0, 0, 160 }, { 0, 255, 0, 255 }, { 0, 0, 255, 90 }, { 255, 255, 0, 255 },
+        { 255, 0, 255, 30 }, { 0, 255, 255, 200 }, { 0, 0, 0, 255 }, { 128, 128, 128, 0 }
+    };
+    JobSystem jobs;
+    char name[64];
+
+    for (const Case& c : cases) {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, c.width, c.height, 32, SDL_PIXELFORMAT_ARGB8888);
+        SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+        if (renderer == NULL) {
+            benchError("software renderer could not be created");
+            return;
+        }
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        Rng rng(2178);
+        std::vector<Circle> circles;
+        std::vector<Rectangle> rectangles;
+        std::vector<Point> points;
+        for (int i = 0; i < c.count; i++) {
+            const float x = rng.uniform() * (c.width + 2 * c.size) - c.size;
+            const float y = rng.uniform() * (c.height + 2 * c.size) - c.size;
+            circles.push_back(Circle(x, y, 1 + rng.below(c.size), palette[rng.below(8)], i % 3 != 0));
+            const float rx = rng.uniform() * (c.width + 2 * c.size) - c.size;
+            const float ry = rng.uniform() * (c.height + 2 * c.size) - c.size;
+            rectangles.push_back(Rectangle(rx, ry, 1 + rng.below(2 * c.size), 1 + rng.below(2 * c.size),
+                                           palette[rng.below(8)], i % 2 == 0));
+            points.push_back(Point(rng.uniform() * c.width, rng.uniform() * c.height, palette[rng.below(8)]));
+        }
+        const int shapes = 3 * c.count;
+        const size_t bytes = (size_t)c.width * c.height * 4;
+        DrawList list;
+        TileRasterizer raster;
+
+        // the reference: flush() to the headless renderer over a background
+        // that isn't opaque white, so the alpha channel is checked too
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        SDL_SetRenderDrawColor(renderer, 0xF0, 0xE0, 0xD0, 0x80);
+        SDL_RenderClear(renderer);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        const std::vector<Uint8> background((Uint8*)surface->pixels, (Uint8*)surface->pixels + bytes);
+        recordScene(circles, rectangles, points, list);
+        list.flush(renderer);
+        const std::vector<Uint8> expected((Uint8*)surface->pixels, (Uint8*)surface->pixels + bytes);
+
+        memcpy(surface->pixels, background.data(), bytes);
+        recordScene(circles, rectangles, points, list);
+        raster.draw(list, surface);
+        if (memcmp(surface->pixels, expected.data(), bytes) != 0) {
+            benchError("raster: tiles differ from the software renderer");
+        }
+        memcpy(surface->pixels, background.data(), bytes);
+        recordScene(circles, rectangles, points, list);
+        raster.draw(list, surface, jobs);
+        if (memcmp(surface->pixels, expected.data(), bytes) != 0) {
+            benchError("raster: threaded tiles differ from the software renderer");
+        }
+        snprintf(name, sizeof(name), "raster/%dx%d/binned_per_shape", c.width, c.height);
+        benchReport(name, (double)raster.lastBinned() / shapes, "tiles");
+
+        // recording is part of every frame, so it's timed on every path
+        double rate = opsPerSecond([&]() {
+            recordScene(circles, rectangles, points, list);
+            list.flush(renderer);
+        });
+        snprintf(name, sizeof(name), "raster/%dx%d/flush", c.width, c.height);
+        benchReport(name, rate * shapes, "shapes/s");
+        rate = opsPerSecond([&]() {
+            recordScene(circles, rectangles, points, list);
+            raster.draw(list, surface);
+        });
+        snprintf(name, sizeof(name), "raster/%dx%d/tiles", c.width, c.height);
+        benchReport(name, rate * shapes, "shapes/s");
+        rate = opsPerSecond([&]() {
+            recordScene(circles, rectangles, points, list);
+            raster.draw(list, surface, jobs);
+        });
+        snprintf(name, sizeof(name), "raster/%dx%d/tiles_threads%d", c.width, c.height, jobs.threadCount());
+        benchReport(name, rate * shapes, "shapes/s");
+
+        SDL_DestroyRenderer(renderer);
+        SDL_FreeSurface(surface);
+    }
+}
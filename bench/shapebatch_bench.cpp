@@ -0,0 +1,106 @@
+#include <SDL2/SDL.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <utility>
+#include <vector>
+#include "../src/utils.hpp"
+#include "../src/random.hpp"
+#include "../src/shapebatch.hpp"
+#include "bench.hpp"
+
+
+// mixed small shapes through Polygon* (one virtual draw each) vs. a ShapeBatch
+BENCHMARK(shapebatch) {
+    const int width = 640;
+    const int height = 480;
+    const int count = 10000;
+    const int palettes[] = { 1, 4 };
+    char name[64];
+
+    SDLWindow window;
+    if (!window.init(width, height, false, BACKEND_HEADLESS)) {
+        benchError("headless window could not be created");
+        return;
+    }
+    SDL_Renderer* renderer = window.getRenderer();
+
+    for (int colors : palettes) {
+        const SDL_Color palette[] = { SDL_COL_RED, SDL_COL_GREEN, SDL_COL_BLUE, SDL_COL_BLACK };
+        Rng rng(2178);
+        ShapeBatch batch;
+        batch.reserve(count, count, count);
+        for (int i = 0; i < count; i++) {
+            const float x = rng.uniform() * width;
+            const float y = rng.uniform() * height;
+            const SDL_Color c = palette[rng.below(colors)];
+            const int type = rng.below(3);
+            if (type == 0) {
+                batch.add(Circle(x, y, 1 + rng.below(4), c, true));
+            } else if (type == 1) {
+                batch.add(Rectangle(x, y, 1 + rng.below(6), 1 + rng.below(6), c, rng.below(2) == 0));
+            } else {
+                batch.add(Point(x, y, c));
+            }
+        }
+        // the virtual path in the batch's order, so the pictures match
+        std::vector<Polygon*> shapes;
+        for (Circle& s : batch.circles()) shapes.push_back(&s);
+        for (Rectangle& s : batch.rectangles()) shapes.push_back(&s);
+        for (Point& s : batch.points()) shapes.push_back(&s);
+
+        SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+        SDL_RenderClear(renderer);
+        double rate = opsPerSecond([&]() {
+            for (Polygon* shape : shapes) {
+                shape->draw(renderer);
+            }
+        });
+        snprintf(name, sizeof(name), "shapebatch/%d/colors%d/virtual", count, colors);
+        benchReport(name, rate * count, "shapes/s");
+        const std::vector<Uint8> expected = benchReadPixels(renderer, width, height);
+
+        SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+        SDL_RenderClear(renderer);
+        rate = opsPerSecond([&]() {
+            batch.draw(renderer);
+        });
+        snprintf(name, sizeof(name), "shapebatch/%d/colors%d/batch", count, colors);
+        benchReport(name, rate * count, "shapes/s");
+        snprintf(name, sizeof(name), "shapebatch/%d/colors%d/draw_calls", count, colors);
+        benchReport(name, batch.lastDrawCalls(), "calls");
+        if (benchReadPixels(renderer, width, height) != expected) {
+            benchError("shapebatch: batch differs from drawing through Polygon::draw");
+        }
+
+        // per-shape work that is cheap next to the call: bounds() through
+        // the vtable (in mixed order, as a scene would hold them) vs.
+        // inlined in the typed loops
+        std::vector<Polygon*> mixed = shapes;
+        for (int i = (int)mixed.size() - 1; i > 0; i--) {
+            std::swap(mixed[i], mixed[rng.below(i + 1)]);
+        }
+        SDL_Rect virtual_box = { 0, 0, 0, 0 };
+        rate = opsPerSecond([&]() {
+            int x0 = INT_MAX, y0 = INT_MAX, x1 = INT_MIN, y1 = INT_MIN;
+            for (Polygon* shape : mixed) {
+                const SDL_Rect b = shape->bounds();
+                x0 = b.x < x0 ? b.x : x0;
+                y0 = b.y < y0 ? b.y : y0;
+                x1 = b.x + b.w > x1 ? b.x + b.w : x1;
+                y1 = b.y + b.h > y1 ? b.y + b.h : y1;
+            }
+            virtual_box = { x0, y0, x1 - x0, y1 - y0 };
+        });
+        snprintf(name, sizeof(name), "shapebatch/%d/colors%d/bounds_virtual", count, colors);
+        benchReport(name, rate * count, "shapes/s");
+        SDL_Rect batch_box = { 0, 0, 0, 0 };
+        rate = opsPerSecond([&]() { batch_box = batch.bounds(); });
+        snprintf(name, sizeof(name), "shapebatch/%d/colors%d/bounds_batch", count, colors);
+        benchReport(name, rate * count, "shapes/s");
+        if (memcmp(&virtual_box, &batch_box, sizeof(SDL_Rect)) != 0) {
+            benchError("shapebatch: batch bounds differ from the virtual ones");
+        }
+    }
+    window.close();
+}
@@ -0,0 +1,110 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <string>
+#include "../src/utils.hpp"
+#include "bench.hpp"
+
+
+// the per-primitive implementation Circle::draw used before batching
+static void legacyCircleDraw(SDL_Renderer* renderer, int mX, int mY, int mRadius, SDL_Color mColor, bool mFillFlag) {
+    const int diameter = (mRadius * 2);
+    int x = (mRadius - 1);
+    int y = 0;
+    int tx = 1;
+    int ty = 1;
+    int error = (tx - diameter);
+
+    SDL_SetRenderDrawColor(renderer, mColor.r, mColor.g, mColor.b, mColor.a);
+    while (x >= y) {
+
+        if (mFillFlag) {
+            SDL_RenderDrawLine(renderer, mX + x, mY + y, mX - x, mY + y);
+            SDL_RenderDrawLine(renderer, mX + x, mY - y, mX - x, mY - y);
+            SDL_RenderDrawLine(renderer, mX + y, mY + x, mX - y, mY + x);
+            SDL_RenderDrawLine(renderer, mX + y, mY - x, mX - y, mY - x);
+        } else {
+            SDL_RenderDrawPoint(renderer, mX + x, mY - y);
+            SDL_RenderDrawPoint(renderer, mX + x, mY + y);
+            SDL_RenderDrawPoint(renderer, mX - x, mY - y);
+            SDL_RenderDrawPoint(renderer, mX - x, mY + y);
+            SDL_RenderDrawPoint(renderer, mX + y, mY - x);
+            SDL_RenderDrawPoint(renderer, mX + y, mY + x);
+            SDL_RenderDrawPoint(renderer, mX - y, mY - x);
+            SDL_RenderDrawPoint(renderer, mX - y, mY + x);
+        }
+
+        if (error <= 0) {
+            ++y;
+            error += ty;
+            ty += 2;
+        }
+        if (error > 0) {
+            --x;
+            tx += 2;
+            error += (tx - diameter);
+        }
+    }
+}
+
+
+// software renderer into a plain surface, so no display is needed
+static SDL_Renderer* createBenchRenderer(SDL_Surface*& surface, int width, int height) {
+    surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    if (renderer == NULL) {
+        benchError("software renderer could not be created");
+        return NULL;
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    return renderer;
+}
+
+
+BENCHMARK(circles) {
+    const int width = 640;
+    const int height = 480;
+    const int radii[] = { 2, 10, 50, 100 };
+    const SDL_Color color = { 255, 0, 0, 128 };
+    char name[64];
+
+    SDL_Surface* surface;
+    SDL_Renderer* renderer = createBenchRenderer(surface, width, height);
+    if (renderer == NULL) {
+        return;
+    }
+
+    for (int fill = 1; fill >= 0; fill--) {
+        for (int radius : radii) {
+            Circle circle(width / 2, height / 2, radius, color, fill);
+            double legacy = opsPerSecond([&]() {
+                legacyCircleDraw(renderer, width / 2, height / 2, radius, color, fill);
+            });
+            double batched = opsPerSecond([&]() {
+                circle.draw(renderer);
+            });
+            snprintf(name, sizeof(name), "circle/%s/r%d/legacy", fill ? "fill" : "outline", radius);
+            benchReport(name, legacy, "circles/s");
+            snprintf(name, sizeof(name), "circle/%s/r%d/batched", fill ? "fill" : "outline", radius);
+            benchReport(name, batched, "circles/s");
+        }
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+}
+
+BENCHMARK(rectangles_points) {
+    SDL_Surface* surface;
+    SDL_Renderer* renderer = createBenchRenderer(surface, 640, 480);
+    if (renderer == NULL) {
+        return;
+    }
+    Rectangle filled(100, 100, 80, 80, SDL_COL_BLUE, true);
+    Rectangle outline(100, 100, 80, 80, SDL_COL_BLUE, false);
+    Point point(100, 100, SDL_COL_BLUE);
+    benchReport("rectangle/fill/80x80", opsPerSecond([&]() { filled.draw(renderer); }), "rects/s");
+    benchReport("rectangle/outline/80x80", opsPerSecond([&]() { outline.draw(renderer); }), "rects/s");
+    benchReport("point", opsPerSecond([&]() { point.draw(renderer); }), "points/s");
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+}
@@ -0,0 +1,98 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <vector>
+#include "../src/utils.hpp"
+#include "../src/particles.hpp"
+#include "../src/random.hpp"
+#include "../src/sprites.hpp"
+#include "bench.hpp"
+
+
+static void clearWhite(SDL_Renderer* renderer) {
+    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+    SDL_RenderClear(renderer);
+}
+
+
+BENCHMARK(sprites) {
+    const int width = 640;
+    const int height = 480;
+    const int count = 10000;
+    const SDL_Color palette[] = { SDL_COL_RED, SDL_COL_GREEN, SDL_COL_BLUE, { 0, 0, 0, 128 } };
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    if (renderer == NULL) {
+        benchError("software renderer could not be created");
+        return;
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SpriteCache sprites(renderer);
+    std::vector<Uint8> expected;
+    Rng rng(2178);
+
+    // walker trails: identical 2px outlines in a few colors
+    std::vector<Circle> walkers;
+    std::vector<SDL_Point> centers;
+    std::vector<SDL_Color> colors;
+    for (int i = 0; i < count; i++) {
+        walkers.push_back(Circle(rng.below(width), rng.below(height), 2, palette[i % 4]));
+        centers.push_back(walkers.back().pixel());
+        colors.push_back(palette[i % 4]);
+    }
+    clearWhite(renderer);
+    for (Circle& walker : walkers) {
+        walker.draw(renderer);
+    }
+    expected = benchReadPixels(renderer, width, height);
+    clearWhite(renderer);
+    sprites.drawCircles(centers.data(), colors.data(), count, 2, SDL_COL_BLACK, false);
+    if (benchReadPixels(renderer, width, height) != expected) {
+        benchError("sprite walkers differ from Circle::draw");
+    }
+    benchReport("sprites/walkers/midpoint", opsPerSecond([&]() {
+        for (Circle& walker : walkers) {
+            walker.draw(renderer);
+        }
+    }) * count, "circles/s");
+    benchReport("sprites/walkers/copy", opsPerSecond([&]() {
+        for (int i = 0; i < count; i++) {
+            sprites.drawCircle(centers[i].x, centers[i].y, 2, colors[i], false);
+        }
+    }) * count, "circles/s");
+    benchReport("sprites/walkers/geometry", opsPerSecond([&]() {
+        sprites.drawCircles(centers.data(), colors.data(), count, 2, SDL_COL_BLACK, false);
+    }) * count, "circles/s");
+
+    // filled particles with a handful of radii
+    ParticleSystem particles;
+    for (int i = 0; i < count; i++) {
+        particles.add(rng.below(width), rng.below(height), 0, 0, 2 + (i / 1000) % 6, palette[i % 4]);
+    }
+    clearWhite(renderer);
+    particles.draw(renderer);
+    expected = benchReadPixels(renderer, width, height);
+    clearWhite(renderer);
+    particles.draw(sprites);
+    if (benchReadPixels(renderer, width, height) != expected) {
+        benchError("sprite particles differ from ParticleSystem::draw");
+    }
+    benchReport("sprites/particles/spans", opsPerSecond([&]() { particles.draw(renderer); }) * count, "circles/s");
+    benchReport("sprites/particles/geometry", opsPerSecond([&]() { particles.draw(sprites); }) * count, "circles/s");
+
+    // worst case: every radius is new, so each draw builds (and evicts) a texture
+    sprites.clear();
+    sprites.setBudget(256 << 10);
+    int radius = 1;
+    benchReport("sprites/miss", opsPerSecond([&]() {
+        sprites.drawCircle(width / 2, height / 2, radius, SDL_COL_RED, true);
+        radius = radius % 100 + 1;
+    }), "circles/s");
+    if (sprites.bytes() > 256 << 10) {
+        benchError("sprite cache went over its budget");
+    }
+
+    sprites.clear();
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+}
@@ -0,0 +1,40 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <vector>
+#include "../src/vec2.hpp"
+#include "../src/random.hpp"
+#include "bench.hpp"
+
+
+BENCHMARK(vec2) {
+    const int count = 1000000;
+    Rng rng(2178);
+    std::vector<Vec2> position(count), velocity(count);
+    for (int i = 0; i < count; i++) {
+        position[i] = Vec2(rng.uniform() * 640, rng.uniform() * 480);
+        velocity[i] = Vec2::fromAngle(rng.uniform() * 6.2831853f, rng.uniform() * 8);
+    }
+
+    // one vector at a time through the operators
+    benchReport("vec2/add_scaled/operators", opsPerSecond([&]() {
+        for (int i = 0; i < count; i++) {
+            position[i] += velocity[i] * 0.016f;
+        }
+    }, 0.3) * count, "vectors/s");
+    benchReport("vec2/add_scaled/batch", opsPerSecond([&]() {
+        addScaled(position.data(), velocity.data(), 0.016f, count);
+    }, 0.3) * count, "vectors/s");
+
+    benchReport("vec2/limit/operators", opsPerSecond([&]() {
+        for (int i = 0; i < count; i++) {
+            velocity[i] = velocity[i].limited(4.0f);
+        }
+    }, 0.3) * count, "vectors/s");
+    benchReport("vec2/limit/batch", opsPerSecond([&]() {
+        limit(velocity.data(), 4.0f, count);
+    }, 0.3) * count, "vectors/s");
+
+    benchReport("vec2/normalize/batch", opsPerSecond([&]() {
+        normalize(velocity.data(), count);
+    }, 0.3) * count, "vectors/s");
+}
@@ -0,0 +1,49 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <vector>
+#include "../src/jobs.hpp"
+#include "../src/walker.hpp"
+#include "bench.hpp"
+
+
+BENCHMARK(walkers) {
+    const int count = 100000;
+    const StepMode modes[] = { STEP_4, STEP_8, STEP_PERLIN, STEP_FLOW };
+    const char* mode_names[] = { "step4", "step8", "perlin", "flow" };
+    NoiseLattice lattice(2178);
+    FlowField flow(640, 480, 10, Noise(lattice));
+    flow.bake(0);
+    Rng rng(2178);
+    JobSystem jobs;
+    char name[64];
+
+    std::vector<RandomWalker> walkers;
+    walkers.reserve(count);
+    for (int i = 0; i < count; i++) {
+        walkers.push_back(RandomWalker(320, 240, SDL_COL_RED, 480, 640, Noise(lattice, i), rng.split()));
+        walkers.back().setFlow(&flow);
+    }
+
+    for (int m = 0; m < 4; m++) {
+        for (RandomWalker& walker : walkers) {
+            walker.setMode(modes[m], modes[m] == STEP_PERLIN ? 0.005f : (modes[m] == STEP_FLOW ? 1 : 2));
+        }
+        double serial = opsPerSecond([&]() {
+            for (RandomWalker& walker : walkers) {
+                walker.update();
+            }
+        });
+        snprintf(name, sizeof(name), "walkers/%s/serial", mode_names[m]);
+        benchReport(name, serial * count, "steps/s");
+
+        double parallel = opsPerSecond([&]() {
+            jobs.parallelFor(0, count, 4096, [&](int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    walkers[i].update();
+                }
+            });
+        });
+        snprintf(name, sizeof(name), "walkers/%s/threads%d", mode_names[m], jobs.threadCount());
+        benchReport(name, parallel * count, "steps/s");
+    }
+}
@@ -0,0 +1,62 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "arena.hpp"
+
+// allocate() promises never to return NULL, so running out of memory ends here
+static char* newBlock(size_t bytes) {
+    char* block = (char*)malloc(bytes > 0 ? bytes : 1);
+    if (block == NULL) {
+        printf("Error: Frame arena could not allocate %zu bytes\n", bytes);
+        abort();
+    }
+    return block;
+}
+
+
+FrameArena::FrameArena(size_t capacity) {
+    mCapacity = capacity;
+    mBlock = newBlock(capacity);
+}
+
+FrameArena::~FrameArena() {
+    for (char* spill : mSpill) {
+        free(spill);
+    }
+    free(mBlock);
+}
+
+void* FrameArena::allocate(size_t bytes, size_t align) {
+    const uintptr_t base = (uintptr_t)mBlock;
+    const uintptr_t start = (base + mUsed + align - 1) & ~(uintptr_t)(align - 1);
+    if (start + bytes <= base + mCapacity) {
+        mUsed = start + bytes - base;
+        return (void*)start;
+    }
+    // doesn't fit this frame: a block of its own, until reset() makes room
+    char* spill = newBlock(bytes + align);
+    mSpill.push_back(spill);
+    mSpillBytes += bytes + align;
+    return (void*)(((uintptr_t)spill + align - 1) & ~(uintptr_t)(align - 1));
+}
+
+void FrameArena::reset() {
+    const size_t used = mUsed + mSpillBytes;
+    if (used > mPeak) {
+        mPeak = used;
+    }
+    if (!mSpill.empty()) {
+        for (char* spill : mSpill) {
+            free(spill);
+        }
+        mSpill.clear();
+        mSpillBytes = 0;
+        // one block big enough for the whole frame next time
+        free(mBlock);
+        mCapacity = used + used / 2;
+        mBlock = newBlock(mCapacity);
+        mGrows++;
+    }
+    mUsed = 0;
+}
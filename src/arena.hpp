@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+
+// Bump allocator for scratch memory that only lives for one frame.
+// alloc() just advances a pointer and reset() frees everything at once,
+// so per-frame buffers cost no malloc/free. If a frame needs more than
+// the capacity it spills into extra blocks, and the next reset() grows
+// the arena to fit, so it stops allocating after the first big frame.
+// Nothing allocated here has its destructor run: use it for plain data.
+class FrameArena {
+    private:
+        char* mBlock;
+        size_t mCapacity;
+        size_t mUsed = 0;
+        std::vector<char*> mSpill; // overflow blocks, freed on reset()
+        size_t mSpillBytes = 0;
+        size_t mPeak = 0;
+        long mGrows = 0;
+    public:
+        FrameArena(size_t capacity = 1 << 20);
+        ~FrameArena();
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+        // bytes aligned to align (a power of two), never NULL: running out
+        // of memory aborts with a message
+        void* allocate(size_t bytes, size_t align = alignof(max_align_t));
+        // uninitialized room for count Ts
+        template <typename T>
+        T* alloc(int count) { return (T*)allocate(count * sizeof(T), alignof(T)); }
+        // free everything allocated since the last reset
+        void reset();
+        size_t used() { return mUsed + mSpillBytes; }
+        size_t capacity() { return mCapacity; }
+        // most bytes used in one frame
+        size_t peak() { return mPeak; }
+        // times reset() had to enlarge the block
+        long grows() { return mGrows; }
+};
@@ -0,0 +1,246 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <vector>
+#include "automata.hpp"
+#include "profiler.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define AUTOMATA_X86 1
+#define AUTOMATA_AVX2_FN __attribute__((target("avx2")))
+#endif
+
+
+// the neighbors to the left (x - 1) and right (x + 1) of every bit of w,
+// with prev/next the words before and after it in the row
+static inline Uint64 leftOf(Uint64 w, Uint64 prev) { return (w << 1) | (prev >> 63); }
+static inline Uint64 rightOf(Uint64 w, Uint64 next) { return (w >> 1) | (next << 63); }
+
+// bitwise adders: 64 independent 1-bit sums at once
+static inline void halfAdd(Uint64 a, Uint64 b, Uint64& sum, Uint64& carry) {
+    sum = a ^ b;
+    carry = a & b;
+}
+static inline void fullAdd(Uint64 a, Uint64 b, Uint64 c, Uint64& sum, Uint64& carry) {
+    const Uint64 t = a ^ b;
+    sum = t ^ c;
+    carry = (a & b) | (t & c);
+}
+
+// next state of the 64 cells of word i, given the word and its neighbors
+// in the rows above (u), at (m) and below (d)
+static inline Uint64 lifeWord(Uint64 up, Uint64 u, Uint64 un, Uint64 mp, Uint64 m, Uint64 mn,
+                              Uint64 dp, Uint64 d, Uint64 dn) {
+    // the 3 cells above, the 3 below and the 2 beside, each as a 2-bit count
+    Uint64 above0, above1, below0, below1, side0, side1;
+    fullAdd(leftOf(u, up), u, rightOf(u, un), above0, above1);
+    fullAdd(leftOf(d, dp), d, rightOf(d, dn), below0, below1);
+    halfAdd(leftOf(m, mp), rightOf(m, mn), side0, side1);
+    // count = ones + 2 (twos0 + twos_carry) + 4 fours
+    Uint64 ones, ones_carry, twos0, fours, twos, twos_carry;
+    fullAdd(above0, below0, side0, ones, ones_carry);
+    fullAdd(above1, below1, side1, twos0, fours);
+    halfAdd(twos0, ones_carry, twos, twos_carry);
+    // alive next if the count is 3, or 2 and alive now
+    return twos & ~(fours | twos_carry) & (ones | m);
+}
+
+// one row of the next generation; the interior loop has no branches and
+// no wraparound, so it vectorizes
+__attribute__((always_inline))
+static inline void lifeRowImpl(const Uint64* __restrict u, const Uint64* __restrict m,
+                               const Uint64* __restrict d, Uint64* __restrict out, int words) {
+    const int last = words - 1;
+    if (words == 1) {
+        out[0] = lifeWord(u[0], u[0], u[0], m[0], m[0], m[0], d[0], d[0], d[0]);
+        return;
+    }
+    out[0] = lifeWord(u[last], u[0], u[1], m[last], m[0], m[1], d[last], d[0], d[1]);
+    for (int i = 1; i < last; i++) {
+        out[i] = lifeWord(u[i - 1], u[i], u[i + 1], m[i - 1], m[i], m[i + 1], d[i - 1], d[i], d[i + 1]);
+    }
+    out[last] = lifeWord(u[last - 1], u[last], u[0], m[last - 1], m[last], m[0],
+                         d[last - 1], d[last], d[0]);
+}
+
+static void lifeRowGeneric(const Uint64* u, const Uint64* m, const Uint64* d, Uint64* out, int words) {
+    lifeRowImpl(u, m, d, out, words);
+}
+
+#ifdef AUTOMATA_X86
+AUTOMATA_AVX2_FN static void lifeRowAVX2(const Uint64* u, const Uint64* m, const Uint64* d,
+                                         Uint64* out, int words) {
+    lifeRowImpl(u, m, d, out, words);
+}
+#endif
+
+
+AutomataPath automataBestPath() {
+#ifdef AUTOMATA_X86
+    static const AutomataPath best = SDL_HasAVX2() ? AUTOMATA_AVX2 : AUTOMATA_GENERIC;
+    return best;
+#else
+    return AUTOMATA_GENERIC;
+#endif
+}
+
+const char* automataPathName(AutomataPath path) {
+    switch (path) {
+        case AUTOMATA_AUTO: return "auto";
+        case AUTOMATA_GENERIC: return "generic";
+        case AUTOMATA_AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+// cells of one packed row as pixels
+static void renderRow(const Uint64* cells, Uint32* row, int width, Uint32 alive, Uint32 dead) {
+    for (int x = 0; x < width; x++) {
+        row[x] = (cells[x >> 6] >> (x & 63)) & 1 ? alive : dead;
+    }
+}
+
+
+// LIFE
+Life::Life(int width, int height) {
+    mWords = (width + 63) / 64;
+    mWidth = mWords * 64;
+    mHeight = height;
+    mCells.assign(mWords * height, 0);
+    mNext.assign(mWords * height, 0);
+}
+
+void Life::set(int x, int y, bool alive) {
+    Uint64& word = mCells[y * mWords + (x >> 6)];
+    const Uint64 bit = (Uint64)1 << (x & 63);
+    word = alive ? (word | bit) : (word & ~bit);
+}
+
+void Life::clear() {
+    std::fill(mCells.begin(), mCells.end(), 0);
+    mGeneration = 0;
+}
+
+void Life::randomize(Rng& rng, float density) {
+    for (Uint64& word : mCells) {
+        if (density == 0.5f) {
+            // every bit of a draw is a fair coin
+            word = rng.next();
+            continue;
+        }
+        word = 0;
+        for (int b = 0; b < 64; b++) {
+            if (rng.uniform() < density) {
+                word |= (Uint64)1 << b;
+            }
+        }
+    }
+    mGeneration = 0;
+}
+
+void Life::stepRows(int begin, int end, AutomataPath path) {
+    for (int y = begin; y < end; y++) {
+        const Uint64* u = &mCells[((y + mHeight - 1) % mHeight) * mWords];
+        const Uint64* m = &mCells[y * mWords];
+        const Uint64* d = &mCells[((y + 1) % mHeight) * mWords];
+        Uint64* out = &mNext[y * mWords];
+#ifdef AUTOMATA_X86
+        if (path == AUTOMATA_AVX2) {
+            lifeRowAVX2(u, m, d, out, mWords);
+            continue;
+        }
+#endif
+        lifeRowGeneric(u, m, d, out, mWords);
+    }
+}
+
+void Life::step(AutomataPath path) {
+    PROFILE_SCOPE("life step");
+    if (path == AUTOMATA_AUTO) {
+        path = automataBestPath();
+    }
+    stepRows(0, mHeight, path);
+    mCells.swap(mNext);
+    mGeneration++;
+}
+
+void Life::step(JobSystem& jobs, AutomataPath path) {
+    PROFILE_SCOPE("life step");
+    if (path == AUTOMATA_AUTO) {
+        path = automataBestPath();
+    }
+    // bands of at least 16 rows, enough words per job to pay for the handoff
+    const int grain = std::max(16, mHeight / (4 * jobs.threadCount()));
+    jobs.parallelFor(0, mHeight, grain, [&](int begin, int end) {
+        stepRows(begin, end, path);
+    });
+    mCells.swap(mNext);
+    mGeneration++;
+}
+
+long Life::population() const {
+    long count = 0;
+    for (Uint64 word : mCells) {
+        count += __builtin_popcountll(word);
+    }
+    return count;
+}
+
+void Life::render(PixelCanvas& canvas, Uint32 alive, Uint32 dead) const {
+    const int width = std::min(mWidth, canvas.width());
+    const int height = std::min(mHeight, canvas.height());
+    for (int y = 0; y < height; y++) {
+        renderRow(row(y), canvas.row(y), width, alive, dead);
+    }
+}
+
+void Life::render(PixelCanvas& canvas, Uint32 alive, Uint32 dead, JobSystem& jobs) const {
+    const int width = std::min(mWidth, canvas.width());
+    const int height = std::min(mHeight, canvas.height());
+    canvas.fillRows(jobs, [&](int begin, int end) {
+        for (int y = begin; y < end && y < height; y++) {
+            renderRow(row(y), canvas.bandRow(y), width, alive, dead);
+        }
+    });
+}
+
+
+// WOLFRAM
+Wolfram::Wolfram(int width, Uint8 rule) {
+    mWords = (width + 63) / 64;
+    mWidth = mWords * 64;
+    mRule = rule;
+    mCells.assign(mWords, 0);
+    mNext.assign(mWords, 0);
+    set(mWidth / 2, true);
+}
+
+void Wolfram::set(int x, bool alive) {
+    Uint64& word = mCells[x >> 6];
+    const Uint64 bit = (Uint64)1 << (x & 63);
+    word = alive ? (word | bit) : (word & ~bit);
+}
+
+void Wolfram::step() {
+    for (int i = 0; i < mWords; i++) {
+        const Uint64 c = mCells[i];
+        const Uint64 l = leftOf(c, mCells[(i + mWords - 1) % mWords]);
+        const Uint64 r = rightOf(c, mCells[(i + 1) % mWords]);
+        // rule bit p is the next state for the pattern (left, center, right) = p
+        Uint64 next = 0;
+        for (int p = 0; p < 8; p++) {
+            if ((mRule >> p) & 1) {
+                next |= ((p & 4) ? l : ~l) & ((p & 2) ? c : ~c) & ((p & 1) ? r : ~r);
+            }
+        }
+        mNext[i] = next;
+    }
+    mCells.swap(mNext);
+    mGeneration++;
+}
+
+void Wolfram::render(PixelCanvas& canvas, int y, Uint32 alive, Uint32 dead) const {
+    if (y < 0 || y >= canvas.height()) {
+        return;
+    }
+    renderRow(mCells.data(), canvas.row(y), std::min(mWidth, canvas.width()), alive, dead);
+}
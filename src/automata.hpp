@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <SDL2/SDL.h>
+#include "canvas.hpp"
+#include "jobs.hpp"
+#include "random.hpp"
+
+
+// which code path a generation is computed with
+enum AutomataPath {
+    AUTOMATA_AUTO,    // best path this cpu supports
+    AUTOMATA_GENERIC, // 64-bit words (plus whatever the compiler vectorizes)
+    AUTOMATA_AVX2     // the same loop compiled for avx2
+};
+
+// Game of Life on a torus, 64 cells per word: bit b of word i in a row is
+// cell x = 64 i + b. A generation adds up the 8 neighbor bitboards with
+// bitwise adders, so every bit operation updates 64 cells (256 with avx2).
+// Width is rounded up to a multiple of 64.
+class Life {
+    private:
+        int mWidth;
+        int mHeight;
+        int mWords; // per row
+        std::vector<Uint64> mCells;
+        std::vector<Uint64> mNext;
+        long mGeneration = 0;
+        void stepRows(int begin, int end, AutomataPath path);
+    public:
+        Life(int width, int height);
+        bool get(int x, int y) const {
+            return (mCells[y * mWords + (x >> 6)] >> (x & 63)) & 1;
+        }
+        void set(int x, int y, bool alive);
+        void clear();
+        // every cell alive with probability density
+        void randomize(Rng& rng, float density = 0.5f);
+        void step(AutomataPath path = AUTOMATA_AUTO);
+        // bands of rows on different threads
+        void step(JobSystem& jobs, AutomataPath path = AUTOMATA_AUTO);
+        long population() const;
+        long generation() const { return mGeneration; }
+        int width() const { return mWidth; }
+        int height() const { return mHeight; }
+        const Uint64* row(int y) const { return &mCells[y * mWords]; }
+        // one pixel per cell, as much of the grid as fits the canvas
+        void render(PixelCanvas& canvas, Uint32 alive, Uint32 dead) const;
+        void render(PixelCanvas& canvas, Uint32 alive, Uint32 dead, JobSystem& jobs) const;
+};
+
+// Elementary (1D, Wolfram) automaton on a ring of cells, packed like Life:
+// each generation all 8 neighborhood patterns are matched 64 cells at a
+// time. Width is rounded up to a multiple of 64.
+class Wolfram {
+    private:
+        int mWidth;
+        int mWords;
+        Uint8 mRule;
+        std::vector<Uint64> mCells;
+        std::vector<Uint64> mNext;
+        long mGeneration = 0;
+    public:
+        // starts with only the middle cell alive
+        Wolfram(int width, Uint8 rule);
+        bool get(int x) const { return (mCells[x >> 6] >> (x & 63)) & 1; }
+        void set(int x, bool alive);
+        void setRule(Uint8 rule) { mRule = rule; };
+        void step();
+        long generation() const { return mGeneration; }
+        int width() const { return mWidth; }
+        const Uint64* cells() const { return mCells.data(); }
+        // the current generation as canvas row y (the sketch picks the row,
+        // e.g. generation() % height to scroll)
+        void render(PixelCanvas& canvas, int y, Uint32 alive, Uint32 dead) const;
+};
+
+AutomataPath automataBestPath();
+const char* automataPathName(AutomataPath path);
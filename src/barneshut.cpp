@@ -0,0 +1,194 @@
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "barneshut.hpp"
+#include "profiler.hpp"
+
+// nodes with this few bodies are summed directly instead of split further
+#define BARNES_HUT_LEAF 8
+// stops splitting when bodies sit on top of each other
+#define BARNES_HUT_MAX_DEPTH 24
+// work is split into chunks of this many bodies across threads
+static const int BARNES_HUT_GRAIN = 1024;
+
+
+BarnesHut::BarnesHut(float theta, float gravity, float softening) {
+    mTheta = theta;
+    mGravity = gravity;
+    mSoftening2 = softening * softening;
+}
+
+void BarnesHut::build(const float* x, const float* y, const float* mass, int count) {
+    PROFILE_SCOPE("barnes-hut build");
+    mNodes.clear();
+    mOrder.resize(count);
+    mX.assign(x, x + count);
+    mY.assign(y, y + count);
+    mMass.assign(mass, mass + count);
+    if (count == 0) {
+        return;
+    }
+    float min_x = x[0], max_x = x[0], min_y = y[0], max_y = y[0];
+    for (int i = 0; i < count; i++) {
+        mOrder[i] = i;
+        min_x = fminf(min_x, x[i]);
+        max_x = fmaxf(max_x, x[i]);
+        min_y = fminf(min_y, y[i]);
+        max_y = fmaxf(max_y, y[i]);
+    }
+    // square root node, a little larger so the max edge falls inside
+    const float half = 0.5f * fmaxf(max_x - min_x, max_y - min_y) * 1.001f + 1e-3f;
+    mNodes.push_back({ 0, 0, 0, 0.5f * (min_x + max_x), 0.5f * (min_y + max_y), half,
+                       0, count, { -1, -1, -1, -1 } });
+    split(0, mNodes[0].cx, mNodes[0].cy, half, 0);
+}
+
+// partition the node's bodies into quadrants, recurse, then fill in the center of mass
+void BarnesHut::split(int node, float cx, float cy, float half, int depth) {
+    const int first = mNodes[node].first;
+    const int count = mNodes[node].count;
+    if (count <= BARNES_HUT_LEAF || depth >= BARNES_HUT_MAX_DEPTH) {
+        float mass = 0, mx = 0, my = 0;
+        for (int k = first; k < first + count; k++) {
+            mass += mMass[k];
+            mx += mMass[k] * mX[k];
+            my += mMass[k] * mY[k];
+        }
+        mNodes[node].mass = mass;
+        mNodes[node].x = mass > 0 ? mx / mass : cx;
+        mNodes[node].y = mass > 0 ? my / mass : cy;
+        return;
+    }
+
+    // in-place partition: left/right on x, then top/bottom on y within each half
+    auto partition = [&](int begin, int end, bool by_x, float pivot) {
+        int i = begin;
+        int j = end - 1;
+        while (i <= j) {
+            const float v = by_x ? mX[i] : mY[i];
+            if (v < pivot) {
+                i++;
+            } else {
+                std::swap(mX[i], mX[j]);
+                std::swap(mY[i], mY[j]);
+                std::swap(mMass[i], mMass[j]);
+                std::swap(mOrder[i], mOrder[j]);
+                j--;
+            }
+        }
+        return i;
+    };
+    const int mid_x = partition(first, first + count, true, cx);
+    const int mid_left = partition(first, mid_x, false, cy);
+    const int mid_right = partition(mid_x, first + count, false, cy);
+    // quadrant q: bit 0 = right, bit 1 = bottom
+    const int begins[4] = { first, mid_x, mid_left, mid_right };
+    const int ends[4] = { mid_left, mid_right, mid_x, first + count };
+
+    float mass = 0, mx = 0, my = 0;
+    const float quarter = 0.5f * half;
+    for (int q = 0; q < 4; q++) {
+        if (ends[q] == begins[q]) {
+            continue;
+        }
+        const float qx = cx + ((q & 1) ? quarter : -quarter);
+        const float qy = cy + ((q & 2) ? quarter : -quarter);
+        const int child = (int)mNodes.size();
+        mNodes.push_back({ 0, 0, 0, qx, qy, quarter, begins[q], ends[q] - begins[q], { -1, -1, -1, -1 } });
+        mNodes[node].child[q] = child;
+        split(child, qx, qy, quarter, depth + 1);
+        mass += mNodes[child].mass;
+        mx += mNodes[child].mass * mNodes[child].x;
+        my += mNodes[child].mass * mNodes[child].y;
+    }
+    mNodes[node].mass = mass;
+    mNodes[node].x = mass > 0 ? mx / mass : cx;
+    mNodes[node].y = mass > 0 ? my / mass : cy;
+}
+
+void BarnesHut::forceOn(int i, float x, float y, float mass, float& fx, float& fy) const {
+    const float theta2 = mTheta * mTheta;
+    float ax = 0;
+    float ay = 0;
+    int stack[4 * BARNES_HUT_MAX_DEPTH + 4];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = mNodes[stack[--top]];
+        const float dx = node.x - x;
+        const float dy = node.y - y;
+        const float d2 = dx * dx + dy * dy;
+        const float size = 2 * node.half;
+        // never summarize a node the body is in, it would pull on itself
+        const bool inside = fabsf(x - node.cx) <= node.half && fabsf(y - node.cy) <= node.half;
+        const bool leaf = node.child[0] < 0 && node.child[1] < 0 && node.child[2] < 0 && node.child[3] < 0;
+        if (!inside && size * size < theta2 * d2) {
+            const float inv = 1.0f / sqrtf(d2 + mSoftening2);
+            const float s = node.mass * inv * inv * inv;
+            ax += dx * s;
+            ay += dy * s;
+        } else if (leaf) {
+            for (int k = node.first; k < node.first + node.count; k++) {
+                if (mOrder[k] == i) {
+                    continue;
+                }
+                const float ex = mX[k] - x;
+                const float ey = mY[k] - y;
+                const float inv = 1.0f / sqrtf(ex * ex + ey * ey + mSoftening2);
+                const float s = mMass[k] * inv * inv * inv;
+                ax += ex * s;
+                ay += ey * s;
+            }
+        } else {
+            for (int q = 0; q < 4; q++) {
+                if (node.child[q] >= 0) {
+                    stack[top++] = node.child[q];
+                }
+            }
+        }
+    }
+    fx = mGravity * mass * ax;
+    fy = mGravity * mass * ay;
+}
+
+void BarnesHut::forces(const float* x, const float* y, const float* mass, float* fx, float* fy, int count) const {
+    PROFILE_SCOPE("barnes-hut forces");
+    for (int i = 0; i < count; i++) {
+        forceOn(i, x[i], y[i], mass[i], fx[i], fy[i]);
+    }
+}
+
+void BarnesHut::forces(const float* x, const float* y, const float* mass, float* fx, float* fy, int count,
+                       JobSystem& jobs) const {
+    PROFILE_SCOPE("barnes-hut forces");
+    // the tree is read-only here, so bodies are independent
+    jobs.parallelFor(0, count, BARNES_HUT_GRAIN, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            forceOn(i, x[i], y[i], mass[i], fx[i], fy[i]);
+        }
+    });
+}
+
+
+void bruteForceForces(const float* x, const float* y, const float* mass, float* fx, float* fy,
+                      int count, float gravity, float softening) {
+    const float softening2 = softening * softening;
+    for (int i = 0; i < count; i++) {
+        // accumulate in double so the reference isn't the noisy side
+        double ax = 0;
+        double ay = 0;
+        for (int j = 0; j < count; j++) {
+            if (j == i) {
+                continue;
+            }
+            const double dx = x[j] - x[i];
+            const double dy = y[j] - y[i];
+            const double inv = 1.0 / sqrt(dx * dx + dy * dy + softening2);
+            const double s = mass[j] * inv * inv * inv;
+            ax += dx * s;
+            ay += dy * s;
+        }
+        fx[i] = (float)(gravity * mass[i] * ax);
+        fy[i] = (float)(gravity * mass[i] * ay);
+    }
+}
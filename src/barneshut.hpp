@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include "jobs.hpp"
+
+
+// Barnes-Hut quadtree for n-body attraction in O(n log n).
+// A node far enough away (node size / distance < theta) acts as a single
+// body at its center of mass; theta = 0 is exact, larger is faster and
+// rougher (0.5 keeps the RMS force error under 1% of the direct sum).
+// Positions and masses are plain arrays, e.g. ParticleSystem columns.
+class BarnesHut {
+    private:
+        struct Node {
+            float x;      // center of mass
+            float y;
+            float mass;
+            float cx;     // center and half size of the node's square
+            float cy;
+            float half;
+            int first;    // bodies are mOrder[first, first + count)
+            int count;
+            int child[4]; // -1 if absent, all -1 for a leaf
+        };
+        std::vector<Node> mNodes;
+        std::vector<int> mOrder;  // body indices grouped by node
+        std::vector<float> mX;    // positions and masses in mOrder order
+        std::vector<float> mY;
+        std::vector<float> mMass;
+        float mTheta;
+        float mGravity;
+        float mSoftening2;
+        void split(int node, float cx, float cy, float half, int depth);
+        void forceOn(int i, float x, float y, float mass, float& fx, float& fy) const;
+    public:
+        // softening keeps close encounters from blowing up
+        BarnesHut(float theta = 0.5f, float gravity = 1.0f, float softening = 1.0f);
+        void setTheta(float theta) { mTheta = theta; };
+        // rebuild the tree from scratch, every tick
+        void build(const float* x, const float* y, const float* mass, int count);
+        // force on every body from all the others, overwrites fx/fy
+        void forces(const float* x, const float* y, const float* mass, float* fx, float* fy, int count) const;
+        void forces(const float* x, const float* y, const float* mass, float* fx, float* fy, int count,
+                    JobSystem& jobs) const;
+        int nodeCount() const { return (int)mNodes.size(); }
+};
+
+// O(n^2) direct sum with the same gravity and softening, as a reference
+void bruteForceForces(const float* x, const float* y, const float* mass, float* fx, float* fy,
+                      int count, float gravity = 1.0f, float softening = 1.0f);
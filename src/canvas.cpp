@@ -0,0 +1,91 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "canvas.hpp"
+#include "profiler.hpp"
+
+
+PixelCanvas::PixelCanvas() {
+    mRenderer = NULL;
+    mTexture = NULL;
+    mWidth = 0;
+    mHeight = 0;
+}
+
+PixelCanvas::~PixelCanvas() {
+    close();
+}
+
+bool PixelCanvas::createTexture() {
+    mTexture = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_ARGB8888,
+                                 SDL_TEXTUREACCESS_STREAMING, mWidth, mHeight);
+    if (mTexture == NULL) {
+        printf("Error: Unable to create canvas texture, SDL_Error: %s\n", SDL_GetError());
+        return false;
+    }
+    // canvas pixels replace what's under them, alpha and all
+    SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_NONE);
+    mChanged = true;
+    return true;
+}
+
+bool PixelCanvas::init(SDL_Renderer* renderer, int width, int height) {
+    close();
+    mRenderer = renderer;
+    mWidth = width;
+    mHeight = height;
+    mPixels.assign(width * height, pack(0, 0, 0));
+    if (!createTexture()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void PixelCanvas::close() {
+    if (mTexture != NULL) {
+        SDL_DestroyTexture(mTexture);
+    }
+    mTexture = NULL;
+    mWidth = 0;
+    mHeight = 0;
+    mPixels.clear();
+}
+
+void PixelCanvas::fill(Uint32 color) {
+    std::fill(mPixels.begin(), mPixels.end(), color);
+    mChanged = true;
+}
+
+void PixelCanvas::fillRows(JobSystem& jobs, const std::function<void(int, int)>& fn) {
+    PROFILE_SCOPE("canvas fill");
+    // a few bands per thread, so an uneven row cost still balances out
+    const int grain = mHeight / (4 * jobs.threadCount()) + 1;
+    jobs.parallelFor(0, mHeight, grain, fn);
+    mChanged = true;
+}
+
+void PixelCanvas::present(const SDL_Rect* dst) {
+    if (mTexture == NULL) {
+        return;
+    }
+    if (mChanged) {
+        PROFILE_SCOPE("canvas upload");
+        SDL_UpdateTexture(mTexture, NULL, mPixels.data(), mWidth * 4);
+        mChanged = false;
+    }
+    SDL_RenderCopy(mRenderer, mTexture, NULL, dst);
+}
+
+bool PixelCanvas::handleEvent(const SDL_Event& event) {
+    if (event.type == SDL_RENDER_DEVICE_RESET) {
+        // the pixels are ours, only the texture has to come back
+        if (mTexture != NULL) {
+            SDL_DestroyTexture(mTexture);
+        }
+        createTexture();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <SDL2/SDL.h>
+#include "jobs.hpp"
+
+
+// Per-pixel drawing without a renderer call per pixel: sketches write
+// ARGB8888 words straight into a contiguous buffer (rows of width()
+// pixels, no padding), and present() uploads it to a streaming texture
+// and copies that to the target, one SDL_UpdateTexture and one
+// SDL_RenderCopy per frame. The buffer lives on the CPU side, so it
+// keeps its contents between frames and survives a device reset.
+class PixelCanvas {
+    private:
+        SDL_Renderer* mRenderer;
+        SDL_Texture* mTexture;
+        int mWidth;
+        int mHeight;
+        std::vector<Uint32> mPixels;
+        bool mChanged = false;
+        bool createTexture();
+    public:
+        PixelCanvas();
+        ~PixelCanvas();
+        bool init(SDL_Renderer* renderer, int width, int height);
+        void close();
+        // 0xAARRGGBB, the buffer's pixel format
+        static Uint32 pack(Uint8 r, Uint8 g, Uint8 b, Uint8 a = 0xFF) {
+            return ((Uint32)a << 24) | ((Uint32)r << 16) | ((Uint32)g << 8) | b;
+        }
+        static Uint32 pack(SDL_Color c) { return pack(c.r, c.g, c.b, c.a); }
+        // writing through these marks the canvas for upload
+        Uint32* pixels() { mChanged = true; return mPixels.data(); }
+        Uint32* row(int y) { mChanged = true; return mPixels.data() + y * mWidth; }
+        // the same without marking, for fillRows callbacks: they run on
+        // several threads, and fillRows marks the canvas once itself
+        Uint32* bandRow(int y) { return mPixels.data() + y * mWidth; }
+        // bounds-checked single pixel, for the odd point
+        void set(int x, int y, Uint32 color) {
+            if (x >= 0 && y >= 0 && x < mWidth && y < mHeight) {
+                mPixels[y * mWidth + x] = color;
+                mChanged = true;
+            }
+        }
+        void fill(Uint32 color);
+        // fn(first_row, end_row) writes rows [first_row, end_row), bands
+        // of rows run on different threads; fn writes through bandRow()
+        void fillRows(JobSystem& jobs, const std::function<void(int, int)>& fn);
+        // upload if anything was written since the last upload, then
+        // copy to dst (NULL for the whole target)
+        void present(const SDL_Rect* dst = NULL);
+        // recreates the texture after SDL_RENDER_DEVICE_RESET, returns true
+        // if the event was that
+        bool handleEvent(const SDL_Event& event);
+        int width() { return mWidth; }
+        int height() { return mHeight; }
+};
@@ -0,0 +1,231 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "capture.hpp"
+
+
+CaptureFormat captureFormatFromPath(std::string path) {
+    const size_t dot = path.find_last_of('.');
+    const std::string ext = dot == std::string::npos ? "" : path.substr(dot);
+    if (path[0] != '|' && (ext == ".rgba" || ext == ".raw")) {
+        return CAPTURE_RAW;
+    }
+    if (path[0] != '|' && ext == ".ppm") {
+        return CAPTURE_PPM;
+    }
+    return CAPTURE_Y4M;
+}
+
+// true if the pattern has exactly one frame number conversion, %d with an
+// optional 0 flag and width (e.g. %05d), and nothing else but %%
+static bool validFramePattern(const std::string& pattern) {
+    int conversions = 0;
+    for (size_t i = 0; i < pattern.size(); i++) {
+        if (pattern[i] != '%') {
+            continue;
+        }
+        i++;
+        if (i < pattern.size() && pattern[i] == '%') {
+            continue;
+        }
+        while (i < pattern.size() && pattern[i] >= '0' && pattern[i] <= '9') {
+            i++;
+        }
+        if (i >= pattern.size() || pattern[i] != 'd') {
+            return false;
+        }
+        conversions++;
+    }
+    return conversions == 1;
+}
+
+
+FrameCapture::~FrameCapture() {
+    close();
+}
+
+bool FrameCapture::open(std::string path, CaptureFormat format, int width, int height,
+                        int fps, bool blocking, int ring_size) {
+    close();
+    mFormat = format;
+    mWidth = width;
+    mHeight = height;
+    mBlocking = blocking;
+    mCaptured = 0;
+    mDropped = 0;
+    mWritten = 0;
+    mWriteFailed = false;
+
+    if (format == CAPTURE_PPM) {
+        mPattern = path;
+        if (path.find('%') == std::string::npos) {
+            const size_t dot = path.find_last_of('.');
+            mPattern = path.substr(0, dot) + "_%05d" + path.substr(dot);
+        }
+        if (!validFramePattern(mPattern)) {
+            fprintf(stderr, "Error: Capture pattern %s needs exactly one %%d (e.g. %%05d)\n", path.c_str());
+            return false;
+        }
+    } else if (path == "-") {
+        mFile = stdout;
+    } else if (path[0] == '|') {
+        mFile = popen(path.c_str() + 1, "w");
+        mPipe = true;
+    } else {
+        mFile = fopen(path.c_str(), "wb");
+    }
+    if (format != CAPTURE_PPM && mFile == NULL) {
+        fprintf(stderr, "Error: Unable to open capture output %s\n", path.c_str());
+        return false;
+    }
+    if (format == CAPTURE_Y4M) {
+        fprintf(mFile, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", width, height, fps);
+    }
+
+    // all buffers up front, so capturing never allocates
+    mSlots.resize(ring_size);
+    for (Slot& slot : mSlots) {
+        slot.pixels.resize((size_t)width * height * 4);
+    }
+    mScratch.resize((size_t)width * height * 3);
+    mHead = 0;
+    mTail = 0;
+    mFilled = 0;
+    mStop = false;
+    mOpen = true;
+    mStartCounter = SDL_GetPerformanceCounter();
+    mWriter = std::thread(&FrameCapture::writerLoop, this);
+    return true;
+}
+
+bool FrameCapture::capture(SDL_Renderer* renderer) {
+    if (!mOpen) {
+        return false;
+    }
+    std::unique_lock<std::mutex> guard(mLock);
+    if (mFilled == (int)mSlots.size()) {
+        if (!mBlocking) {
+            mDropped++;
+            return false;
+        }
+        mFree.wait(guard, [this]() { return mFilled < (int)mSlots.size(); });
+    }
+    Slot& slot = mSlots[mHead];
+    guard.unlock();
+
+    // the writer never looks at a slot until it is handed over below
+    if (SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_RGBA32, slot.pixels.data(), mWidth * 4) < 0) {
+        fprintf(stderr, "Error: Unable to read back frame, SDL_Error: %s\n", SDL_GetError());
+        return false;
+    }
+    slot.frame = mCaptured++;
+
+    guard.lock();
+    mHead = (mHead + 1) % (int)mSlots.size();
+    mFilled++;
+    guard.unlock();
+    mReady.notify_one();
+    return true;
+}
+
+void FrameCapture::writerLoop() {
+    while (true) {
+        std::unique_lock<std::mutex> guard(mLock);
+        mReady.wait(guard, [this]() { return mFilled > 0 || mStop; });
+        if (mFilled == 0) {
+            return; // stopping, and everything queued is written
+        }
+        const Slot& slot = mSlots[mTail];
+        guard.unlock();
+
+        if (writeFrame(slot)) {
+            mWritten++;
+        } else if (!mWriteFailed) {
+            fprintf(stderr, "Error: Unable to write captured frame %ld\n", slot.frame);
+            mWriteFailed = true;
+        }
+
+        guard.lock();
+        mTail = (mTail + 1) % (int)mSlots.size();
+        mFilled--;
+        guard.unlock();
+        mFree.notify_one();
+    }
+}
+
+bool FrameCapture::writeFrame(const Slot& slot) {
+    const size_t pixels = (size_t)mWidth * mHeight;
+    const Uint8* src = slot.pixels.data();
+    Uint8* dst = mScratch.data();
+
+    if (mFormat == CAPTURE_RAW) {
+        return fwrite(src, 4, pixels, mFile) == pixels;
+    }
+
+    if (mFormat == CAPTURE_PPM) {
+        for (size_t i = 0; i < pixels; i++) {
+            dst[i * 3 + 0] = src[i * 4 + 0];
+            dst[i * 3 + 1] = src[i * 4 + 1];
+            dst[i * 3 + 2] = src[i * 4 + 2];
+        }
+        char name[1024];
+        // the pattern was checked in open(): one %d
+        snprintf(name, sizeof(name), mPattern.c_str(), (int)slot.frame);
+        FILE* file = fopen(name, "wb");
+        if (file == NULL) {
+            return false;
+        }
+        fprintf(file, "P6\n%d %d\n255\n", mWidth, mHeight);
+        const bool ok = fwrite(dst, 3, pixels, file) == pixels;
+        fclose(file);
+        return ok;
+    }
+
+    // y4m: planar Y, U, V at full resolution (BT.601, studio range)
+    Uint8* y_plane = dst;
+    Uint8* u_plane = dst + pixels;
+    Uint8* v_plane = dst + pixels * 2;
+    for (size_t i = 0; i < pixels; i++) {
+        const int r = src[i * 4 + 0];
+        const int g = src[i * 4 + 1];
+        const int b = src[i * 4 + 2];
+        y_plane[i] = (Uint8)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        u_plane[i] = (Uint8)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        v_plane[i] = (Uint8)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+    if (fputs("FRAME\n", mFile) < 0) {
+        return false;
+    }
+    return fwrite(dst, 3, pixels, mFile) == pixels;
+}
+
+void FrameCapture::close() {
+    if (!mOpen) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        mStop = true;
+    }
+    mReady.notify_one();
+    mWriter.join();
+    mElapsed = (double)(SDL_GetPerformanceCounter() - mStartCounter) / SDL_GetPerformanceFrequency();
+
+    if (mPipe) {
+        pclose(mFile);
+    } else if (mFile != NULL && mFile != stdout) {
+        fclose(mFile);
+    } else if (mFile == stdout) {
+        fflush(stdout);
+    }
+    mFile = NULL;
+    mPipe = false;
+    mOpen = false;
+}
+
+void FrameCapture::printStats() {
+    // stderr, since stdout may be the capture stream
+    fprintf(stderr, "capture: %ld frames written, %ld dropped, %.1f fps at %dx%d\n",
+            mWritten, mDropped, mElapsed > 0 ? mWritten / mElapsed : 0.0, mWidth, mHeight);
+}
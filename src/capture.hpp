@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <SDL2/SDL.h>
+
+
+enum CaptureFormat {
+    CAPTURE_RAW, // raw RGBA frames back to back
+    CAPTURE_PPM, // one binary PPM file per frame
+    CAPTURE_Y4M  // YUV4MPEG2 (4:4:4) stream, e.g. for piping into ffmpeg
+};
+
+// .rgba/.raw -> raw, .ppm -> ppm sequence, anything else -> y4m
+CaptureFormat captureFormatFromPath(std::string path);
+
+
+// Records rendered frames without holding up the render loop.
+// capture() copies the frame into the next free buffer of a small
+// preallocated ring and returns; a writer thread converts and streams
+// the buffers out. If the writer falls behind, frames are dropped (and
+// counted), unless the capture was opened as blocking, in which case
+// capture() waits for a free buffer instead (for offline/headless runs
+// where every frame matters more than pace).
+//
+// Paths: a file name, "-" for stdout, or "|command" to pipe into a
+// process. PPM paths may contain one %d conversion (flags limited to a
+// zero pad and width, e.g. frames/out_%05d.ppm) for the frame number,
+// otherwise _%05d is added before the extension; any other % but %% is
+// rejected by open().
+class FrameCapture {
+    private:
+        struct Slot {
+            std::vector<Uint8> pixels; // RGBA
+            long frame;
+        };
+        std::vector<Slot> mSlots;
+        int mHead = 0;   // next slot capture() fills
+        int mTail = 0;   // next slot the writer drains
+        int mFilled = 0;
+        std::mutex mLock;
+        std::condition_variable mReady;
+        std::condition_variable mFree;
+        std::thread mWriter;
+        bool mStop = false;
+        bool mOpen = false;
+
+        CaptureFormat mFormat;
+        std::string mPattern; // ppm sequence file name pattern
+        FILE* mFile = NULL;
+        bool mPipe = false;
+        bool mBlocking = false;
+        int mWidth = 0;
+        int mHeight = 0;
+        std::vector<Uint8> mScratch; // writer-side conversion buffer
+
+        long mCaptured = 0;
+        long mDropped = 0;
+        long mWritten = 0;
+        bool mWriteFailed = false;
+        Uint64 mStartCounter = 0;
+        double mElapsed = 0;
+
+        void writerLoop();
+        bool writeFrame(const Slot& slot);
+    public:
+        FrameCapture() {};
+        ~FrameCapture();
+        bool open(std::string path, CaptureFormat format, int width, int height,
+                  int fps, bool blocking = false, int ring_size = 4);
+        // read back the current frame (call before SDL_RenderPresent)
+        // - returns false if the frame was dropped or couldn't be read
+        bool capture(SDL_Renderer* renderer);
+        // flush queued frames and stop the writer
+        void close();
+        bool isOpen() { return mOpen; }
+        long captured() { return mCaptured; }
+        long dropped() { return mDropped; }
+        long written() { return mWritten; }
+        void printStats();
+};
@@ -0,0 +1,110 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <vector>
+#include "damage.hpp"
+#include "profiler.hpp"
+
+
+DamageTracker::DamageTracker(int width, int height, int max_rects) {
+    mWidth = width;
+    mHeight = height;
+    mMaxRects = max_rects < 1 ? 1 : max_rects;
+    invalidate();
+}
+
+void DamageTracker::resize(int width, int height) {
+    mWidth = width;
+    mHeight = height;
+    invalidate();
+}
+
+void DamageTracker::invalidate() {
+    mRects.clear();
+    mRects.push_back({ 0, 0, mWidth, mHeight });
+}
+
+int DamageTracker::area() {
+    int total = 0;
+    for (const SDL_Rect& r : mRects) {
+        total += r.w * r.h;
+    }
+    return total;
+}
+
+void DamageTracker::add(SDL_Rect rect) {
+    const SDL_Rect screen = { 0, 0, mWidth, mHeight };
+    if (!SDL_IntersectRect(&rect, &screen, &rect)) {
+        return;
+    }
+    // absorb every rect it overlaps, so the list stays disjoint and no
+    // pixel is drawn twice (blended shapes would darken)
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < mRects.size(); i++) {
+            if (SDL_HasIntersection(&mRects[i], &rect)) {
+                SDL_UnionRect(&mRects[i], &rect, &rect);
+                mRects[i] = mRects.back();
+                mRects.pop_back();
+                merged = true;
+                break;
+            }
+        }
+    }
+    if ((int)mRects.size() >= mMaxRects) {
+        // too many passes: fold it into the rect whose union grows least
+        size_t best = 0;
+        long best_growth = -1;
+        for (size_t i = 0; i < mRects.size(); i++) {
+            SDL_Rect u;
+            SDL_UnionRect(&mRects[i], &rect, &u);
+            const long growth = (long)u.w * u.h - (long)mRects[i].w * mRects[i].h;
+            if (best_growth < 0 || growth < best_growth) {
+                best = i;
+                best_growth = growth;
+            }
+        }
+        SDL_UnionRect(&mRects[best], &rect, &rect);
+        mRects[best] = mRects.back();
+        mRects.pop_back();
+        // the union may overlap others now
+        add(rect);
+        return;
+    }
+    mRects.push_back(rect);
+}
+
+void DamageTracker::moved(SDL_Rect before, SDL_Rect after) {
+    if (before.x == after.x && before.y == after.y && before.w == after.w && before.h == after.h) {
+        return;
+    }
+    add(before);
+    add(after);
+}
+
+void DamageTracker::redraw(SDL_Renderer* renderer, SDL_Color background, const std::function<void()>& draw) {
+    PROFILE_SCOPE("damage redraw");
+    const int dirty = area();
+    mFrames++;
+    mDirtyPixels += dirty;
+    if (dirty >= mWidth * mHeight) {
+        mFullFrames++;
+    }
+    for (const SDL_Rect& r : mRects) {
+        SDL_RenderSetClipRect(renderer, &r);
+        // SDL_RenderClear ignores the clip rect, an opaque fill doesn't
+        SDL_SetRenderDrawColor(renderer, background.r, background.g, background.b, 0xFF);
+        SDL_RenderFillRect(renderer, &r);
+        draw();
+    }
+    SDL_RenderSetClipRect(renderer, NULL);
+    mRects.clear();
+}
+
+void DamageTracker::printStats() {
+    if (mFrames == 0) {
+        return;
+    }
+    fprintf(stderr, "damage: %.1f%% of the screen redrawn per frame, %ld/%ld full frames\n",
+            100.0 * mDirtyPixels / ((double)mFrames * mWidth * mHeight), mFullFrames, mFrames);
+}
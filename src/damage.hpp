@@ -0,0 +1,41 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <SDL2/SDL.h>
+
+
+// Damage tracking for sparse scenes: instead of clearing and redrawing the
+// whole window, collect the rectangles that changed (where shapes were
+// and where they are now) and redraw only those, clipped with
+// SDL_RenderSetClipRect. Needs a target that keeps its pixels between
+// frames (a TrailBuffer, or the headless framebuffer).
+class DamageTracker {
+    private:
+        std::vector<SDL_Rect> mRects; // disjoint, inside the screen
+        int mWidth;
+        int mHeight;
+        int mMaxRects;
+        long mFrames = 0;
+        long mFullFrames = 0;
+        double mDirtyPixels = 0;
+        int area();
+    public:
+        // past max_rects the closest pair is merged, so redraw() never
+        // makes more than max_rects passes
+        DamageTracker(int width, int height, int max_rects = 8);
+        // new screen size, everything is dirty
+        void resize(int width, int height);
+        void add(SDL_Rect rect);
+        // a shape drawn at before now draws at after
+        void moved(SDL_Rect before, SDL_Rect after);
+        // redraw everything next frame (first frame, lost render targets)
+        void invalidate();
+        bool empty() { return mRects.empty(); }
+        const std::vector<SDL_Rect>& rects() { return mRects; }
+        // for each dirty rect: clip to it, fill it with background and
+        // call draw(); then reset the clip and forget the damage
+        void redraw(SDL_Renderer* renderer, SDL_Color background, const std::function<void()>& draw);
+        // share of the screen redrawn per frame, to stderr
+        void printStats();
+};
@@ -0,0 +1,192 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <vector>
+#include "drawlist.hpp"
+#include "utils.hpp"
+#include "profiler.hpp"
+
+// how many batches back a command may be merged into; past this a new
+// batch is started, which keeps flush linear for long lists
+#define DRAWLIST_LOOKBACK 32
+
+
+// the blend mode isn't part of the key: SDL_ComposeCustomBlendMode values
+// use all 32 bits, so it is kept and compared as a field of its own
+static Uint64 drawKey(SDL_Color color, DrawPrimitive primitive) {
+    const Uint64 rgba = ((Uint64)color.r << 24) | ((Uint64)color.g << 16) |
+                        ((Uint64)color.b << 8) | (Uint64)color.a;
+    return (rgba << 32) | (Uint64)primitive;
+}
+
+
+void DrawList::push(SDL_Color color, DrawPrimitive primitive, SDL_Rect bounds, int first, int count) {
+    if (count <= 0) {
+        return;
+    }
+    mCommands.push_back({ drawKey(color, primitive), mBlendMode, bounds, first, count, -1 });
+}
+
+void DrawList::point(SDL_Color color, int x, int y) {
+    mPoints.push_back({ x, y });
+    push(color, DRAW_POINTS, { x, y, 1, 1 }, (int)mPoints.size() - 1, 1);
+}
+
+void DrawList::points(SDL_Color color, const SDL_Point* points, int count) {
+    if (count <= 0) {
+        return;
+    }
+    int min_x = points[0].x, max_x = points[0].x;
+    int min_y = points[0].y, max_y = points[0].y;
+    for (int i = 1; i < count; i++) {
+        if (points[i].x < min_x) min_x = points[i].x;
+        if (points[i].x > max_x) max_x = points[i].x;
+        if (points[i].y < min_y) min_y = points[i].y;
+        if (points[i].y > max_y) max_y = points[i].y;
+    }
+    const int first = (int)mPoints.size();
+    mPoints.insert(mPoints.end(), points, points + count);
+    push(color, DRAW_POINTS, { min_x, min_y, max_x - min_x + 1, max_y - min_y + 1 }, first, count);
+}
+
+void DrawList::rect(SDL_Color color, const SDL_Rect& rect, bool fill) {
+    mRects.push_back(rect);
+    push(color, fill ? DRAW_FILL_RECTS : DRAW_RECTS, rect, (int)mRects.size() - 1, 1);
+}
+
+void DrawList::circle(SDL_Color color, int cx, int cy, int radius, bool fill) {
+    const SDL_Rect bounds = { cx - radius, cy - radius, 2 * radius + 1, 2 * radius + 1 };
+    if (fill) {
+        const int first = (int)mRects.size();
+        circleSpans(cx, cy, radius, mRects);
+        push(color, DRAW_FILL_RECTS, bounds, first, (int)mRects.size() - first);
+    } else {
+        const int first = (int)mPoints.size();
+        circleOutline(cx, cy, radius, mPoints);
+        push(color, DRAW_POINTS, bounds, first, (int)mPoints.size() - first);
+    }
+}
+
+void DrawList::clear() {
+    mCommands.clear();
+    mPoints.clear();
+    mRects.clear();
+}
+
+
+// true if anything in the batch overlaps the bounds
+bool DrawList::blocked(const Batch& batch, const SDL_Rect& bounds) {
+    if (!SDL_HasIntersection(&batch.bounds, &bounds)) {
+        return false;
+    }
+    for (int i = batch.head; i != -1; i = mCommands[i].next) {
+        if (SDL_HasIntersection(&mCommands[i].bounds, &bounds)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int DrawList::flush(SDL_Renderer* renderer) {
+    PROFILE_SCOPE("drawlist");
+    DrawStats stats;
+    stats.commands = (int)mCommands.size();
+
+    // group commands: walk back over the recent batches and join the first
+    // one with the same state, unless something in between is in the way
+    mBatches.clear();
+    for (int i = 0; i < (int)mCommands.size(); i++) {
+        Command& command = mCommands[i];
+        int target = -1;
+        const int stop = (int)mBatches.size() > DRAWLIST_LOOKBACK ?
+                         (int)mBatches.size() - DRAWLIST_LOOKBACK : 0;
+        for (int b = (int)mBatches.size() - 1; b >= stop; b--) {
+            if (mBatches[b].key == command.key && mBatches[b].blend == command.blend) {
+                target = b;
+                break;
+            }
+            if (blocked(mBatches[b], command.bounds)) {
+                break;
+            }
+        }
+        if (target == -1) {
+            mBatches.push_back({ command.key, command.blend, command.bounds, i, i });
+        } else {
+            Batch& batch = mBatches[target];
+            SDL_UnionRect(&batch.bounds, &command.bounds, &batch.bounds);
+            mCommands[batch.tail].next = i;
+            batch.tail = i;
+        }
+    }
+
+    // one state change and one draw call per batch, skipping repeated state
+    Uint64 color = 0;
+    SDL_BlendMode blend = SDL_BLENDMODE_NONE;
+    for (const Batch& batch : mBatches) {
+        const DrawPrimitive primitive = (DrawPrimitive)(batch.key & 0xFF);
+        const Uint64 batch_color = batch.key >> 32;
+        if (batch.blend != blend || stats.drawCalls == 0) {
+            SDL_SetRenderDrawBlendMode(renderer, batch.blend);
+            blend = batch.blend;
+            stats.stateChanges++;
+        }
+        if (batch_color != color || stats.drawCalls == 0) {
+            SDL_SetRenderDrawColor(renderer, (batch_color >> 24) & 0xFF, (batch_color >> 16) & 0xFF,
+                                   (batch_color >> 8) & 0xFF, batch_color & 0xFF);
+            color = batch_color;
+            stats.stateChanges++;
+        }
+        if (primitive == DRAW_POINTS) {
+            const SDL_Point* data = &mPoints[mCommands[batch.head].first];
+            int count = mCommands[batch.head].count;
+            if (batch.head != batch.tail) {
+                // gather the batch into one contiguous run
+                mPointScratch.clear();
+                for (int i = batch.head; i != -1; i = mCommands[i].next) {
+                    const SDL_Point* points = &mPoints[mCommands[i].first];
+                    mPointScratch.insert(mPointScratch.end(), points, points + mCommands[i].count);
+                }
+                data = mPointScratch.data();
+                count = (int)mPointScratch.size();
+            }
+            SDL_RenderDrawPoints(renderer, data, count);
+        } else {
+            const SDL_Rect* data = &mRects[mCommands[batch.head].first];
+            int count = mCommands[batch.head].count;
+            if (batch.head != batch.tail) {
+                mRectScratch.clear();
+                for (int i = batch.head; i != -1; i = mCommands[i].next) {
+                    const SDL_Rect* rects = &mRects[mCommands[i].first];
+                    mRectScratch.insert(mRectScratch.end(), rects, rects + mCommands[i].count);
+                }
+                data = mRectScratch.data();
+                count = (int)mRectScratch.size();
+            }
+            if (primitive == DRAW_FILL_RECTS) {
+                SDL_RenderFillRects(renderer, data, count);
+            } else {
+                SDL_RenderDrawRects(renderer, data, count);
+            }
+        }
+        stats.drawCalls++;
+    }
+    clear();
+
+    mLastStats = stats;
+    mTotalCommands += stats.commands;
+    mTotalDrawCalls += stats.drawCalls;
+    mTotalStateChanges += stats.stateChanges;
+    mFlushes++;
+    return stats.drawCalls;
+}
+
+void DrawList::printStats() {
+    if (mFlushes == 0) {
+        return;
+    }
+    // drawing immediately costs a color change and a draw call per command
+    fprintf(stderr, "draw list: %.1f commands, %.1f draw calls, %.1f state changes per flush "
+            "(immediate: %.1f draw calls, %.1f state changes)\n",
+            (double)mTotalCommands / mFlushes, (double)mTotalDrawCalls / mFlushes,
+            (double)mTotalStateChanges / mFlushes,
+            (double)mTotalCommands / mFlushes, (double)mTotalCommands / mFlushes);
+}
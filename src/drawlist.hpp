@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <SDL2/SDL.h>
+
+
+enum DrawPrimitive {
+    DRAW_POINTS,
+    DRAW_RECTS,     // rectangle outlines
+    DRAW_FILL_RECTS
+};
+
+// per-flush counters, to compare against drawing each shape immediately
+// (which costs one SDL_SetRenderDrawColor plus one draw call per shape)
+struct DrawStats {
+    int commands = 0;     // shapes recorded
+    int drawCalls = 0;    // SDL_RenderDraw*/SDL_RenderFillRects calls issued
+    int stateChanges = 0; // SDL_SetRenderDrawColor/BlendMode calls issued
+};
+
+// Command buffer between the shapes and SDL_Renderer.
+// Shapes record their primitives here instead of drawing them; flush()
+// groups commands with the same color, blend mode and primitive into one
+// SDL call each. A command is only moved earlier into an existing group
+// when it doesn't overlap anything recorded in between with a different
+// state, so the picture is the same as drawing in record order.
+class DrawList {
+    private:
+        struct Command {
+            Uint64 key;     // color and primitive
+            SDL_BlendMode blend;
+            SDL_Rect bounds;
+            int first;      // range in mPoints or mRects
+            int count;
+            int next;       // next command in the same batch, -1 at the end
+        };
+        struct Batch {
+            Uint64 key;
+            SDL_BlendMode blend;
+            SDL_Rect bounds; // union of the commands' bounds
+            int head;
+            int tail;
+        };
+        std::vector<Command> mCommands;
+        std::vector<SDL_Point> mPoints;
+        std::vector<SDL_Rect> mRects;
+        SDL_BlendMode mBlendMode = SDL_BLENDMODE_BLEND;
+        // flush scratch, reused between frames
+        std::vector<Batch> mBatches;
+        std::vector<SDL_Point> mPointScratch;
+        std::vector<SDL_Rect> mRectScratch;
+        DrawStats mLastStats;
+        long mTotalCommands = 0;
+        long mTotalDrawCalls = 0;
+        long mTotalStateChanges = 0;
+        long mFlushes = 0;
+        // reads the commands directly instead of flushing them
+        friend class TileRasterizer;
+        void push(SDL_Color color, DrawPrimitive primitive, SDL_Rect bounds, int first, int count);
+        bool blocked(const Batch& batch, const SDL_Rect& bounds);
+    public:
+        DrawList() {};
+        // applies to everything recorded after it
+        void setBlendMode(SDL_BlendMode mode) { mBlendMode = mode; };
+        void point(SDL_Color color, int x, int y);
+        void points(SDL_Color color, const SDL_Point* points, int count);
+        void rect(SDL_Color color, const SDL_Rect& rect, bool fill);
+        void circle(SDL_Color color, int cx, int cy, int radius, bool fill);
+        int size() { return (int)mCommands.size(); }
+        // drop recorded commands without drawing them
+        void clear();
+        // submit everything recorded and clear, returns the number of draw calls
+        int flush(SDL_Renderer* renderer);
+        DrawStats lastStats() { return mLastStats; }
+        // averages per flush, to stderr
+        void printStats();
+};
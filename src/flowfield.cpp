@@ -0,0 +1,112 @@
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "flowfield.hpp"
+#include "profiler.hpp"
+
+
+FlowField::FlowField(float width, float height, float cell_size, const Noise& noise) :
+    mNoise(noise)
+{
+    mWidth = width;
+    mHeight = height;
+    mCellSize = cell_size;
+    mInvCellSize = 1.0f / cell_size;
+    mColumns = std::max(1, (int)ceilf(width / cell_size));
+    mRows = std::max(1, (int)ceilf(height / cell_size));
+    mDX.assign((mColumns + 1) * (mRows + 1), 1.0f);
+    mDY.assign((mColumns + 1) * (mRows + 1), 0.0f);
+    mNoiseX.resize(mColumns + 1);
+    mNoiseZ.resize(mColumns + 1);
+    setNoise(noise, mNoiseScale, mNoiseTurns);
+}
+
+void FlowField::setNoise(const Noise& noise, float scale, float turns) {
+    mNoise = noise;
+    mNoiseScale = scale;
+    mNoiseTurns = turns;
+    mUseNoise = true;
+    for (int i = 0; i <= mColumns; i++) {
+        mNoiseX[i] = i * mCellSize * mNoiseScale;
+    }
+}
+
+void FlowField::setFunction(const FlowFunction& fn) {
+    mFunction = fn;
+    mUseNoise = false;
+}
+
+void FlowField::bakeRows(int begin, int end, float t) {
+    const int nodes = mColumns + 1;
+    if (!mUseNoise) {
+        for (int j = begin; j < end; j++) {
+            for (int i = 0; i < nodes; i++) {
+                const Vec2 d = mFunction(i * mCellSize, j * mCellSize, t);
+                mDX[j * nodes + i] = d.x;
+                mDY[j * nodes + i] = d.y;
+            }
+        }
+        return;
+    }
+    // a row of nodes is one noise batch; the row's own storage holds its y
+    // coordinates and then its angles, so baking allocates nothing (and
+    // bands of rows can bake on different threads)
+    const float to_radians = mNoiseTurns * 2 * (float)M_PI;
+    for (int j = begin; j < end; j++) {
+        float* dx = &mDX[j * nodes];
+        float* dy = &mDY[j * nodes];
+        std::fill(dy, dy + nodes, j * mCellSize * mNoiseScale);
+        mNoise.sampleBatch(mNoiseX.data(), dy, mNoiseZ.data(), dx, nodes);
+        for (int i = 0; i < nodes; i++) {
+            const float angle = dx[i] * to_radians;
+            dx[i] = cosf(angle);
+            dy[i] = sinf(angle);
+        }
+    }
+}
+
+void FlowField::bake(float t) {
+    PROFILE_SCOPE("flow bake");
+    std::fill(mNoiseZ.begin(), mNoiseZ.end(), t);
+    bakeRows(0, mRows + 1, t);
+    mNextRow = 0;
+}
+
+void FlowField::bake(float t, JobSystem& jobs) {
+    PROFILE_SCOPE("flow bake");
+    std::fill(mNoiseZ.begin(), mNoiseZ.end(), t);
+    jobs.parallelFor(0, mRows + 1, 8, [&](int begin, int end) {
+        bakeRows(begin, end, t);
+    });
+    mNextRow = 0;
+}
+
+void FlowField::refresh(float t, int rows) {
+    PROFILE_SCOPE("flow refresh");
+    const int total = mRows + 1;
+    if (rows <= 0) {
+        return;
+    }
+    rows = std::min(rows, total);
+    std::fill(mNoiseZ.begin(), mNoiseZ.end(), t);
+    const int end = mNextRow + rows;
+    bakeRows(mNextRow, std::min(end, total), t);
+    if (end > total) {
+        bakeRows(0, end - total, t);
+    }
+    mNextRow = end % total;
+}
+
+void FlowField::steer(const float* x, const float* y, const float* vx, const float* vy,
+                      float* ax, float* ay, int count, float max_speed, float max_force) const {
+    PROFILE_SCOPE("flow steer");
+    for (int i = 0; i < count; i++) {
+        const Vec2 desired = lookup(x[i], y[i]) * max_speed;
+        const Vec2 force(desired.x - vx[i], desired.y - vy[i]);
+        // limit as a select (see limit() in vec2.hpp)
+        const float len = force.length();
+        const float s = max_force / (len > max_force ? len : max_force);
+        ax[i] += force.x * s;
+        ay[i] += force.y * s;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "vec2.hpp"
+#include "noise.hpp"
+#include "jobs.hpp"
+
+
+// direction of the flow at (x, y) at time t
+typedef std::function<Vec2(float x, float y, float t)> FlowFunction;
+
+// Directions baked into a grid (the flow field of chapter 6), so agents
+// pay for a bilinear lookup instead of evaluating noise themselves.
+// Directions are stored at the grid nodes, (columns + 1) x (rows + 1)
+// of them, covering [0, width] x [0, height].
+// An animated field can be refreshed a few node rows per frame instead of
+// all at once; rows are then at most one full cycle behind.
+class FlowField {
+    private:
+        float mWidth;
+        float mHeight;
+        float mCellSize;
+        float mInvCellSize;
+        int mColumns; // cells across; nodes are one more
+        int mRows;
+        std::vector<float> mDX; // per node
+        std::vector<float> mDY;
+        // the source: a function, or noise turned into an angle
+        FlowFunction mFunction;
+        Noise mNoise;
+        bool mUseNoise = false;
+        float mNoiseScale = 0.01f;
+        float mNoiseTurns = 2.0f;
+        // noise x and z of a row of nodes, the same for every row
+        std::vector<float> mNoiseX;
+        std::vector<float> mNoiseZ;
+        int mNextRow = 0;
+        void bakeRows(int begin, int end, float t);
+    public:
+        FlowField(float width, float height, float cell_size, const Noise& noise);
+        // angle = noise(x scale, y scale, t) * turns full turns
+        void setNoise(const Noise& noise, float scale, float turns = 2.0f);
+        void setFunction(const FlowFunction& fn);
+        // every node at time t
+        void bake(float t);
+        void bake(float t, JobSystem& jobs);
+        // the next `rows` node rows at time t, round robin (none if rows <= 0)
+        void refresh(float t, int rows);
+        // bilinear between the 4 surrounding nodes, clamped to the field
+        // (so not quite unit length where neighbors disagree)
+        Vec2 lookup(float x, float y) const {
+            float fx = x * mInvCellSize;
+            float fy = y * mInvCellSize;
+            fx = fx < 0 ? 0 : (fx > mColumns ? mColumns : fx);
+            fy = fy < 0 ? 0 : (fy > mRows ? mRows : fy);
+            int cx = (int)fx;
+            int cy = (int)fy;
+            cx = cx >= mColumns ? mColumns - 1 : cx;
+            cy = cy >= mRows ? mRows - 1 : cy;
+            const float ax = fx - cx;
+            const float ay = fy - cy;
+            const int stride = mColumns + 1;
+            const int i = cy * stride + cx;
+            const float top_x = lerp(ax, mDX[i], mDX[i + 1]);
+            const float top_y = lerp(ax, mDY[i], mDY[i + 1]);
+            const float bottom_x = lerp(ax, mDX[i + stride], mDX[i + stride + 1]);
+            const float bottom_y = lerp(ax, mDY[i + stride], mDY[i + stride + 1]);
+            return Vec2(lerp(ay, top_x, bottom_x), lerp(ay, top_y, bottom_y));
+        }
+        // Reynolds steering for many agents: accelerate towards the flow
+        // at max_speed, by at most max_force (a += limit(flow * max_speed - v))
+        void steer(const float* x, const float* y, const float* vx, const float* vy,
+                   float* ax, float* ay, int count, float max_speed, float max_force) const;
+        int columns() const { return mColumns; }
+        int rows() const { return mRows; }
+        float cellSize() const { return mCellSize; }
+};
@@ -2,61 +2,130 @@
 #include <stdio.h>
 #include <string>
 #include "utils.hpp"
+#include "particles.hpp"
+#include "loop.hpp"
+#include "profiler.hpp"
+#include "damage.hpp"
+#include "trails.hpp"
 
 
 int main( int argc, char* args[] )
 {
-    bool quit = false;
-    SDL_Event e;
+    SketchOptions options;
+    if (!parseSketchOptions(argc, args, options)) {
+        return 1;
+    }
     SDLWindow window;
     SDL_Renderer* renderer;
-    // initialize SDL
-    if (!window.init(640, 480)) {
+    // initialize SDL (a window, or a CPU framebuffer when headless)
+    if (!window.init(640, 480, !options.uncapped,
+                     options.headless ? BACKEND_HEADLESS : BACKEND_WINDOW)) {
         printf("Failed to initialize\n");
         return 1;
     }
     renderer = window.getRenderer();
 
-    Circle circle(0, 240, 100, SDL_COL_RED, true);
-    Circle circle2(0, 240, 50, SDL_COL_GREEN, true);
+    ParticleSystem circles;
+    circles.add(0, 240, 3, 0, 100, SDL_COL_RED);
+    circles.add(0, 240, 4, 0, 50, SDL_COL_GREEN);
     Rectangle rect(0, 240, 80, 80, SDL_COL_BLUE, false);
-    int anim_frame = 0;
+    float rect_prev_x = rect.x();
 
-    while (!quit) {
-        while (SDL_PollEvent(&e) != 0) {
-            if (e.type == SDL_QUIT) {
-                quit = true;
-            } else {
-                // handle events
-            }
+    // --dirty: only the regions the shapes left or entered are redrawn,
+    // into a scene buffer that keeps everything else from the last frame.
+    // The headless framebuffer keeps its pixels anyway, so draw straight
+    // into it (unless the overlay is drawn over it every frame).
+    DamageTracker damage(window.width(), window.height());
+    TrailBuffer scene;
+    const bool direct = window.isHeadless() && !options.overlay;
+    if (options.dirty && !direct) {
+        if (!scene.init(renderer, window.width(), window.height(), SDL_COL_WHITE)) {
+            return 1;
         }
-        // clear screen
-        SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-        SDL_RenderClear(renderer);
-        // move shapes
-        circle.move(circle.x() + 3, circle.y());
-        circle2.move(circle2.x() + 4, circle2.y());
-        rect.move(rect.x() + 2, rect.y());
-        // wrap around screen
-        if (circle.x() - circle.radius() >= window.width()) {
-            circle.move(0 - circle.radius(), 240);
+    }
+    SDL_Rect rect_drawn = rect.bounds();
+
+    // velocities are in pixels per tick
+    const int tick_rate = 15;
+    Loop loop(window, tick_rate);
+    loop.setUncapped(options.uncapped);
+    loop.setMaxFrames(options.frames);
+    FrameCapture capture;
+    if (!options.capturePath.empty()) {
+        // headless runs wait for the writer rather than drop frames
+        if (!capture.open(options.capturePath, captureFormatFromPath(options.capturePath),
+                          window.width(), window.height(), tick_rate, options.headless)) {
+            return 1;
         }
-        if (circle2.x() - circle2.radius() >= window.width()) {
-            circle2.move(0 - circle.radius(), 240);
+        loop.setCapture(&capture);
+    }
+    if (!options.tracePath.empty()) {
+        Profiler::get().startTrace(options.tracePath);
+    }
+    Profiler::get().setOverlay(options.overlay);
+    loop.onEvent([&](const SDL_Event& event) {
+        if (options.dirty && !direct && scene.handleEvent(event)) {
+            damage.resize(scene.width(), scene.height());
         }
-        if (rect.x() >= window.width()) {
-            rect.move(0 - rect.width(), 240);
+    });
+    loop.run(
+        [&](double) {
+            // move shapes
+            circles.integrate(1, INTEGRATE_SEMI_IMPLICIT);
+            rect_prev_x = rect.x();
+            rect.move(rect.x() + 2, rect.y());
+            // wrap around screen
+            circles.constrain(BOUNDARY_WRAP, window.width(), window.height());
+            if (rect.x() >= window.width()) {
+                rect.move(0 - rect.width(), 240);
+                rect_prev_x = rect.x() - 2;
+            }
+        },
+        [&](double alpha) {
+            // shapes between the last two ticks
+            Rectangle drawn = rect;
+            drawn.move(lerp((float)alpha, rect_prev_x, rect.x()), rect.y());
+            if (options.dirty) {
+                circles.damage(damage, alpha);
+                damage.moved(rect_drawn, drawn.bounds());
+                rect_drawn = drawn.bounds();
+                if (!direct) scene.begin();
+                damage.redraw(renderer, SDL_COL_WHITE, [&]() {
+                    circles.draw(renderer, alpha);
+                    drawn.draw(renderer);
+                });
+                if (!direct) {
+                    scene.end();
+                    scene.present();
+                }
+            } else {
+                // clear screen
+                SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+                SDL_RenderClear(renderer);
+                circles.draw(renderer, alpha);
+                drawn.draw(renderer);
+            }
         }
-        // draw circle
-        circle.draw(renderer);
-        circle2.draw(renderer);
-        rect.draw(renderer);
-        // update screen
-        SDL_RenderPresent(renderer);
-        SDL_Delay(60);
+    );
+    if (options.uncapped) {
+        loop.printStats();
+        if (options.dirty) {
+            damage.printStats();
+        }
+    }
+    if (!options.savePath.empty()) {
+        window.saveFrame(options.savePath);
     }
+    if (capture.isOpen()) {
+        capture.close();
+        capture.printStats();
+    }
+    if (!options.tracePath.empty()) {
+        Profiler::get().stopTrace();
+    }
+#ifdef NOC_PROFILE
+    Profiler::get().printSummary();
+#endif
 
     window.close();
 }
-
-
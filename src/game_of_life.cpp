@@ -0,0 +1,93 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <string>
+#include "utils.hpp"
+#include "automata.hpp"
+#include "canvas.hpp"
+#include "jobs.hpp"
+#include "loop.hpp"
+#include "profiler.hpp"
+#include "random.hpp"
+
+
+int main( int argc, char* args[] )
+{
+    // fixed seed, so every run starts from the same soup
+    Rng rng(2178);
+    SketchOptions options;
+    if (!parseSketchOptions(argc, args, options)) {
+        return 1;
+    }
+    SDLWindow window;
+    SDL_Renderer* renderer;
+    // initialize SDL (a window, or a CPU framebuffer when headless)
+    if (!window.init(640, 480, !options.uncapped,
+                     options.headless ? BACKEND_HEADLESS : BACKEND_WINDOW)) {
+        printf("Failed to initialize\n");
+        return 1;
+    }
+    renderer = window.getRenderer();
+
+    // one cell per pixel, wrapping at the window edges
+    Life life(window.width(), window.height());
+    life.randomize(rng, 0.3f);
+    JobSystem jobs;
+
+    // cells are written straight into the canvas, one upload per frame
+    PixelCanvas canvas;
+    if (!canvas.init(renderer, window.width(), window.height())) {
+        return 1;
+    }
+    const Uint32 alive = PixelCanvas::pack(SDL_COL_BLACK);
+    const Uint32 dead = PixelCanvas::pack(SDL_COL_WHITE);
+
+    const int tick_rate = 30;
+    Loop loop(window, tick_rate);
+    loop.setUncapped(options.uncapped);
+    loop.setMaxFrames(options.frames);
+    FrameCapture capture;
+    if (!options.capturePath.empty()) {
+        // headless runs wait for the writer rather than drop frames
+        if (!capture.open(options.capturePath, captureFormatFromPath(options.capturePath),
+                          window.width(), window.height(), tick_rate, options.headless)) {
+            return 1;
+        }
+        loop.setCapture(&capture);
+    }
+    if (!options.tracePath.empty()) {
+        Profiler::get().startTrace(options.tracePath);
+    }
+    Profiler::get().setOverlay(options.overlay);
+    loop.onEvent([&](const SDL_Event& event) {
+        canvas.handleEvent(event);
+    });
+    loop.run(
+        [&](double) {
+            life.step(jobs);
+        },
+        [&](double) {
+            // generations are discrete, nothing to interpolate
+            life.render(canvas, alive, dead, jobs);
+            canvas.present();
+        }
+    );
+    if (options.uncapped) {
+        loop.printStats();
+        fprintf(stderr, "generation %ld, population %ld\n", life.generation(), life.population());
+    }
+    if (!options.savePath.empty()) {
+        window.saveFrame(options.savePath);
+    }
+    if (capture.isOpen()) {
+        capture.close();
+        capture.printStats();
+    }
+    if (!options.tracePath.empty()) {
+        Profiler::get().stopTrace();
+    }
+#ifdef NOC_PROFILE
+    Profiler::get().printSummary();
+#endif
+
+    window.close();
+}
@@ -0,0 +1,129 @@
+#include <math.h>
+#include <vector>
+#include "grid.hpp"
+#include "profiler.hpp"
+
+
+SpatialGrid::SpatialGrid(float width, float height, float cell_size) {
+    mWidth = width;
+    mHeight = height;
+    mCellSize = cell_size;
+    mInvCellSize = 1.0f / cell_size;
+    mColumns = (int)ceilf(width / cell_size);
+    mRows = (int)ceilf(height / cell_size);
+    if (mColumns < 1) mColumns = 1;
+    if (mRows < 1) mRows = 1;
+    mCellStart.assign(mColumns * mRows + 1, 0);
+}
+
+int SpatialGrid::cellIndex(float x, float y) const {
+    int cx = (int)(x * mInvCellSize);
+    int cy = (int)(y * mInvCellSize);
+    cx = cx < 0 ? 0 : (cx >= mColumns ? mColumns - 1 : cx);
+    cy = cy < 0 ? 0 : (cy >= mRows ? mRows - 1 : cy);
+    return cy * mColumns + cx;
+}
+
+void SpatialGrid::cellRange(float x0, float y0, float x1, float y1,
+                            int& cx0, int& cy0, int& cx1, int& cy1) const {
+    const int c0 = cellIndex(x0, y0);
+    const int c1 = cellIndex(x1, y1);
+    cx0 = c0 % mColumns;
+    cy0 = c0 / mColumns;
+    cx1 = c1 % mColumns;
+    cy1 = c1 / mColumns;
+}
+
+void SpatialGrid::rebuild(const float* x, const float* y, int count) {
+    PROFILE_SCOPE("grid rebuild");
+    const int cells = mColumns * mRows;
+
+    // same entities in the same cells: the order still holds, only refresh positions
+    if (count == (int)mCellOf.size()) {
+        int moves = 0;
+        for (int i = 0; i < count; i++) {
+            const int cell = cellIndex(x[i], y[i]);
+            moves += (cell != mCellOf[i]);
+            mCellOf[i] = cell;
+        }
+        mLastRebuildMoves = moves;
+        if (moves == 0) {
+            for (int e = 0; e < count; e++) {
+                mEntryX[e] = x[mEntries[e]];
+                mEntryY[e] = y[mEntries[e]];
+            }
+            return;
+        }
+    } else {
+        mCellOf.resize(count);
+        for (int i = 0; i < count; i++) {
+            mCellOf[i] = cellIndex(x[i], y[i]);
+        }
+        mLastRebuildMoves = -1;
+    }
+
+    // counting sort by cell, over every entity however few moved
+    mCellStart.assign(cells + 1, 0);
+    for (int i = 0; i < count; i++) {
+        mCellStart[mCellOf[i] + 1]++;
+    }
+    for (int c = 0; c < cells; c++) {
+        mCellStart[c + 1] += mCellStart[c];
+    }
+    mCursor.assign(mCellStart.begin(), mCellStart.end() - 1);
+    mEntries.resize(count);
+    mEntryX.resize(count);
+    mEntryY.resize(count);
+    for (int i = 0; i < count; i++) {
+        const int e = mCursor[mCellOf[i]]++;
+        mEntries[e] = i;
+        mEntryX[e] = x[i];
+        mEntryY[e] = y[i];
+    }
+}
+
+int SpatialGrid::queryRadius(float x, float y, float radius, std::vector<int>& out) const {
+    int cx0, cy0, cx1, cy1;
+    cellRange(x - radius, y - radius, x + radius, y + radius, cx0, cy0, cx1, cy1);
+    const float r2 = radius * radius;
+    const int before = (int)out.size();
+    for (int cy = cy0; cy <= cy1; cy++) {
+        // the cells of one row are contiguous, so scan them as one run
+        const int begin = mCellStart[cy * mColumns + cx0];
+        const int end = mCellStart[cy * mColumns + cx1 + 1];
+        for (int e = begin; e < end; e++) {
+            const float dx = mEntryX[e] - x;
+            const float dy = mEntryY[e] - y;
+            if (dx * dx + dy * dy <= r2) {
+                out.push_back(mEntries[e]);
+            }
+        }
+    }
+    return (int)out.size() - before;
+}
+
+int SpatialGrid::queryRect(float x, float y, float width, float height, std::vector<int>& out) const {
+    int cx0, cy0, cx1, cy1;
+    cellRange(x, y, x + width, y + height, cx0, cy0, cx1, cy1);
+    const int before = (int)out.size();
+    for (int cy = cy0; cy <= cy1; cy++) {
+        const int begin = mCellStart[cy * mColumns + cx0];
+        const int end = mCellStart[cy * mColumns + cx1 + 1];
+        for (int e = begin; e < end; e++) {
+            const float px = mEntryX[e];
+            const float py = mEntryY[e];
+            if (px >= x && px < x + width && py >= y && py < y + height) {
+                out.push_back(mEntries[e]);
+            }
+        }
+    }
+    return (int)out.size() - before;
+}
+
+int SpatialGrid::query(Circle& circle, std::vector<int>& out) const {
+    return queryRadius(circle.x(), circle.y(), (float)circle.radius(), out);
+}
+
+int SpatialGrid::query(Rectangle& rect, std::vector<int>& out) const {
+    return queryRect(rect.x(), rect.y(), (float)rect.width(), (float)rect.height(), out);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include "utils.hpp"
+
+
+// Uniform grid over a width x height world for neighbor queries.
+// rebuild() bins point positions (e.g. ParticleSystem::x()/y()) with a
+// counting sort, so each cell's entries sit next to each other along
+// with a copy of their positions. Positions outside the world are
+// clamped into the edge cells.
+// Queries are read-only and safe to run from several threads at once.
+class SpatialGrid {
+    private:
+        float mWidth;
+        float mHeight;
+        float mCellSize;
+        float mInvCellSize;
+        int mColumns;
+        int mRows;
+        std::vector<int> mCellStart; // entries of cell c are [mCellStart[c], mCellStart[c + 1])
+        std::vector<int> mEntries;   // entity indices ordered by cell
+        std::vector<float> mEntryX;  // positions in the same order as mEntries
+        std::vector<float> mEntryY;
+        std::vector<int> mCellOf;    // each entity's cell as of the last rebuild
+        std::vector<int> mCursor;    // rebuild scratch
+        int mLastRebuildMoves = 0;
+        int cellIndex(float x, float y) const;
+        void cellRange(float x0, float y0, float x1, float y1, int& cx0, int& cy0, int& cx1, int& cy1) const;
+    public:
+        // cell_size is usually the typical query radius
+        SpatialGrid(float width, float height, float cell_size);
+        // a full counting sort of every entity whenever the count changed or
+        // any entity changed cell (so most frames of a moving simulation);
+        // only when none did does it just refresh the stored positions.
+        // Not incremental: patching just the movers into the cell order
+        // measured no faster than the sort with 0.5-5% of entities moving
+        void rebuild(const float* x, const float* y, int count);
+        // indices whose position is within radius of (x, y), appended to out
+        int queryRadius(float x, float y, float radius, std::vector<int>& out) const;
+        // indices whose position is inside the box, appended to out
+        int queryRect(float x, float y, float width, float height, std::vector<int>& out) const;
+        // shape helpers: entities within the circle / rectangle
+        int query(Circle& circle, std::vector<int>& out) const;
+        int query(Rectangle& rect, std::vector<int>& out) const;
+        int size() const { return (int)mEntries.size(); }
+        int columns() const { return mColumns; }
+        int rows() const { return mRows; }
+        float cellSize() const { return mCellSize; }
+        // entities that changed cell in the last rebuild (any but 0 means it
+        // re-sorted; -1 when the count changed)
+        int lastRebuildMoves() const { return mLastRebuildMoves; }
+};
@@ -0,0 +1,128 @@
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "jobs.hpp"
+#include "profiler.hpp"
+
+
+JobSystem::JobSystem(int threads) : mQueued(0) {
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+    }
+    for (int i = 0; i < threads; i++) {
+        mWorkers.push_back(new Worker());
+    }
+    // worker 0 is whoever calls parallelFor
+    for (int i = 1; i < threads; i++) {
+        mThreads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> guard(mSleepLock);
+        mStop = true;
+    }
+    mWake.notify_all();
+    for (std::thread& thread : mThreads) {
+        thread.join();
+    }
+    for (Worker* worker : mWorkers) {
+        delete worker;
+    }
+}
+
+bool JobSystem::pop(int worker, Job& job) {
+    Worker* w = mWorkers[worker];
+    std::lock_guard<std::mutex> guard(w->lock);
+    if (w->jobs.empty()) {
+        return false;
+    }
+    job = w->jobs.back();
+    w->jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::steal(int thief, Job& job) {
+    const int count = threadCount();
+    for (int i = 1; i < count; i++) {
+        Worker* victim = mWorkers[(thief + i) % count];
+        std::lock_guard<std::mutex> guard(victim->lock);
+        if (!victim->jobs.empty()) {
+            job = victim->jobs.front();
+            victim->jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::runOne(int worker) {
+    Job job;
+    if (!pop(worker, job) && !steal(worker, job)) {
+        return false;
+    }
+    mQueued--;
+    {
+        PROFILE_SCOPE("job");
+        (*job.fn)(job.begin, job.end);
+    }
+    job.pending->fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void JobSystem::workerLoop(int worker) {
+    while (true) {
+        if (runOne(worker)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(mSleepLock);
+        mWake.wait(guard, [this]() { return mStop || mQueued.load() > 0; });
+        if (mStop) {
+            return;
+        }
+    }
+}
+
+void JobSystem::parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& fn) {
+    const int count = end - begin;
+    if (count <= 0) {
+        return;
+    }
+    const int threads = threadCount();
+    if (grain <= 0) {
+        // a few chunks per thread, so stealing can even out uneven work
+        grain = (count + threads * 4 - 1) / (threads * 4);
+    }
+    if (threads == 1 || count <= grain) {
+        fn(begin, end);
+        return;
+    }
+
+    // deal chunks out round-robin, then wake everyone up
+    std::atomic<int> pending((count + grain - 1) / grain);
+    int worker = 0;
+    for (int b = begin; b < end; b += grain) {
+        const int e = (end - b < grain) ? end : b + grain;
+        Worker* w = mWorkers[worker];
+        {
+            std::lock_guard<std::mutex> guard(w->lock);
+            w->jobs.push_back({ &fn, b, e, &pending });
+        }
+        mQueued++;
+        worker = (worker + 1) % threads;
+    }
+    {
+        std::lock_guard<std::mutex> guard(mSleepLock);
+    }
+    mWake.notify_all();
+
+    // help until every chunk has finished (including ones other threads stole)
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!runOne(0)) {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Fixed pool of worker threads, each with its own job deque.
+// A worker takes work from the back of its own deque and, when that is
+// empty, steals from the front of the others. The thread that calls
+// parallelFor works as worker 0, so SDL calls stay on the main thread
+// and the main thread helps out instead of idling.
+class JobSystem {
+    private:
+        struct Job {
+            const std::function<void(int, int)>* fn;
+            int begin;
+            int end;
+            std::atomic<int>* pending;
+        };
+        struct Worker {
+            std::mutex lock;
+            std::deque<Job> jobs;
+        };
+        std::vector<Worker*> mWorkers;
+        std::vector<std::thread> mThreads;
+        std::atomic<int> mQueued;
+        std::mutex mSleepLock;
+        std::condition_variable mWake;
+        bool mStop = false;
+        bool pop(int worker, Job& job);
+        bool steal(int thief, Job& job);
+        bool runOne(int worker);
+        void workerLoop(int worker);
+    public:
+        // threads = 0 uses one thread per core (including the caller)
+        JobSystem(int threads = 0);
+        ~JobSystem();
+        int threadCount() { return (int)mWorkers.size(); }
+        // run fn(chunk_begin, chunk_end) over [begin, end) in chunks of at
+        // most `grain` items and return when every chunk is done
+        // - grain <= 0 picks a chunk size from the thread count
+        // - not reentrant: don't call parallelFor from inside fn
+        void parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& fn);
+};
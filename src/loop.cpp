@@ -0,0 +1,100 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <math.h>
+#include "loop.hpp"
+#include "profiler.hpp"
+
+
+Loop::Loop(SDLWindow& window, double ticks_per_second, int max_ticks_per_frame) :
+    mWindow(window),
+    mTickSeconds(1.0 / ticks_per_second),
+    mMaxTicksPerFrame(max_ticks_per_frame)
+{}
+
+void Loop::pollEvents() {
+    SDL_Event e;
+    while (SDL_PollEvent(&e) != 0) {
+        if (e.type == SDL_QUIT) {
+            mQuit = true;
+        } else if (mOnEvent) {
+            mOnEvent(e);
+        }
+    }
+}
+
+void Loop::run(const std::function<void(double)>& update, const std::function<void(double)>& render) {
+    const double freq = (double)SDL_GetPerformanceFrequency();
+    const Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 last = start;
+    double accumulator = 0;
+    mQuit = false;
+
+    while (!mQuit) {
+        {
+            PROFILE_SCOPE("events");
+            pollEvents();
+        }
+        if (mQuit) {
+            break;
+        }
+
+        double alpha = 1.0;
+        if (mUncapped) {
+            PROFILE_SCOPE("update");
+            update(mTickSeconds);
+            mTicks++;
+        } else {
+            const Uint64 now = SDL_GetPerformanceCounter();
+            accumulator += (now - last) / freq;
+            last = now;
+            int ticks_this_frame = 0;
+            while (accumulator >= mTickSeconds && ticks_this_frame < mMaxTicksPerFrame) {
+                PROFILE_SCOPE("update");
+                update(mTickSeconds);
+                accumulator -= mTickSeconds;
+                mTicks++;
+                ticks_this_frame++;
+            }
+            // still owing ticks after the cap - drop them instead of
+            // spending even longer on the next frame
+            mFallingBehind = accumulator >= mTickSeconds;
+            if (mFallingBehind) {
+                mDroppedTicks += (long)(accumulator / mTickSeconds);
+                accumulator = fmod(accumulator, mTickSeconds);
+            }
+            alpha = accumulator / mTickSeconds;
+        }
+
+        {
+            PROFILE_SCOPE("render");
+            render(alpha);
+        }
+        if (mCapture != NULL) {
+            PROFILE_SCOPE("capture");
+            mCapture->capture(mWindow.getRenderer());
+        }
+        // drawn after capture, so recordings stay clean
+        if (Profiler::get().overlay()) {
+            Profiler::get().drawOverlay(mWindow.getRenderer());
+        }
+        {
+            PROFILE_SCOPE("present");
+            SDL_RenderPresent(mWindow.getRenderer());
+        }
+        PROFILE_FRAME();
+        mFrames++;
+        if (mMaxFrames > 0 && mFrames >= mMaxFrames) {
+            mQuit = true;
+        }
+    }
+    mElapsed = (SDL_GetPerformanceCounter() - start) / freq;
+}
+
+void Loop::printStats() {
+    // stderr, so a capture streamed to stdout stays clean
+    fprintf(stderr, "%ld frames, %ld ticks in %.2fs (%.1f fps, %.1f ticks/s), %ld ticks dropped\n",
+           mFrames, mTicks, mElapsed,
+           mElapsed > 0 ? mFrames / mElapsed : 0.0,
+           mElapsed > 0 ? mTicks / mElapsed : 0.0,
+           mDroppedTicks);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <functional>
+#include <SDL2/SDL.h>
+#include "utils.hpp"
+#include "capture.hpp"
+
+
+// Fixed-timestep main loop: the simulation ticks at a constant rate no
+// matter how fast frames are drawn, and render() gets how far we are
+// between the last tick and the next so it can interpolate.
+// https://gafferongames.com/post/fix_your_timestep/
+class Loop {
+    private:
+        SDLWindow& mWindow;
+        double mTickSeconds;
+        int mMaxTicksPerFrame;
+        bool mUncapped = false;
+        bool mQuit = false;
+        bool mFallingBehind = false;
+        long mMaxFrames = 0;
+        long mTicks = 0;
+        long mFrames = 0;
+        long mDroppedTicks = 0;
+        double mElapsed = 0;
+        std::function<void(const SDL_Event&)> mOnEvent;
+        FrameCapture* mCapture = NULL;
+        void pollEvents();
+    public:
+        // max_ticks_per_frame caps catch-up work after a slow frame; ticks
+        // beyond it are dropped (and counted) rather than spiralling
+        Loop(SDLWindow& window, double ticks_per_second, int max_ticks_per_frame = 5);
+        // benchmark mode: exactly one tick per frame, no waiting on the clock
+        void setUncapped(bool uncapped) { mUncapped = uncapped; };
+        // stop after this many frames (0 = run until quit)
+        void setMaxFrames(long frames) { mMaxFrames = frames; };
+        // called for every event except SDL_QUIT, which stops the loop
+        void onEvent(const std::function<void(const SDL_Event&)>& handler) { mOnEvent = handler; };
+        // hand every rendered frame to a capture before presenting it
+        void setCapture(FrameCapture* capture) { mCapture = capture; };
+        void quit() { mQuit = true; };
+        // update(dt) runs at the fixed tick rate, render(alpha) once per frame
+        // with alpha in [0, 1]; the loop presents after render
+        void run(const std::function<void(double)>& update, const std::function<void(double)>& render);
+        double tickSeconds() { return mTickSeconds; }
+        // true if the last frame had to drop ticks to keep up
+        bool fallingBehind() { return mFallingBehind; }
+        long ticks() { return mTicks; }
+        long frames() { return mFrames; }
+        long droppedTicks() { return mDroppedTicks; }
+        // wall clock seconds spent in the last run()
+        double elapsed() { return mElapsed; }
+        void printStats();
+};
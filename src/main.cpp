@@ -1,213 +1,149 @@
 #include <SDL2/SDL.h>
 #include <stdio.h>
 #include <string>
+#include <vector>
 #include "utils.hpp"
-#include <cmath>
+#include "noise.hpp"
+#include "random.hpp"
+#include "jobs.hpp"
+#include "loop.hpp"
+#include "profiler.hpp"
+#include "walker.hpp"
+#include "sprites.hpp"
+#include "trails.hpp"
 
 
-float map(float value, float in_min, float in_max, float out_min, float out_max) {
-    return (value - in_min) / (in_max - in_min) * (out_max - out_min) + out_min;
-}
-
-float lerp(float alpha, float a, float b) {
-    // (1 - alpha)*a + alpha*b
-    return a + alpha * (b - a);
-}
-
-
-class RandomWalker: public Circle {
-    private:
-        const int mWindowHeight;
-        const int mWindowWidth;
-        const int perlin_size = 4095;
-        float perlin[4096];
-        float tx = 0.01;
-        float ty = 1000;
-        float scaled_cosine(float x) {
-            return 0.5 * (1.0 - cos(x * M_PI));
-        }
-        float perlin_noise(float x, float y=0, float z=0) {
-            // https://github.com/processing/p5.js/blob/33883e5a326fcc3c1ba73a50d74b910af077a688/src/math/noise.js#L254
-            const int perlin_ywrapb = 4;
-            const int perlin_ywrap = 1 << perlin_ywrapb;
-            const int perlin_zwrapb = 8;
-            const int perlin_zwrap = 1 << perlin_zwrapb;
-            const int perlin_octaves = 4;
-            const float perlin_amp_falloff = 0.5;
-
-            int xi = (int)floor(x);
-            float xf = x - xi;
-            int yi = (int)floor(y);
-            float yf = y - yi;
-            int zi = (int)floor(z);
-            float zf = z - zi;
-
-            float r = 0, ampl = 0.5;
-            float rxf, ryf;
-            int of;
-            float n1, n2, n3;
-
-            for (int i = 0; i < perlin_octaves; i++) {
-                of = xi + (yi << perlin_ywrapb) + (zi << perlin_zwrapb);
-
-                rxf = scaled_cosine(xf);
-                ryf = scaled_cosine(yf);
-
-                n1 = perlin[of & perlin_size];
-                n1 += rxf * (perlin[(of + 1) & perlin_size] - n1);
-                n2 = perlin[(of + perlin_ywrap) & perlin_size];
-                n2 += rxf * (perlin[(of + perlin_ywrap + 1) & perlin_size] - n2);
-                n1 += ryf * (n2 - n1);
-
-                of += perlin_zwrap;
-                n2 = perlin[of & perlin_size];
-                n2 += rxf * (perlin[(of + 1) & perlin_size] - n2);
-                n3 = perlin[(of + perlin_ywrap) & perlin_size];
-                n3 += rxf * (perlin[(of + perlin_ywrap + 1) & perlin_size] - n3);
-                n2 += ryf * (n3 - n2);
-
-                n1 += scaled_cosine(zf) * (n2 - n1);
-
-                r += n1 * ampl;
-                ampl *= perlin_amp_falloff;
-                xi <<= 1;
-                xf *= 2;
-                yi <<= 1;
-                yf *= 2;
-                zi <<= 1;
-                zf *= 2;
-
-                if (xf >= 1.0) {
-                    xi++;
-                    xf--;
-                }
-                if (yf >= 1.0) {
-                    yi++;
-                    yf--;
-                }
-                if (zf >= 1.0) {
-                    zi++;
-                    zf--;
-                }
-            }
-            return r;
-        }
-    public:
-        RandomWalker(int x, int y, SDL_Color color, int window_height, int window_width) :
-            Circle(x, y, 2, color),
-            mWindowHeight(window_height),
-            mWindowWidth(window_width)
-        {
-            // init perlin array
-            for (int i = 0; i < perlin_size; i++) {
-                perlin[i] = (float)rand() / RAND_MAX;
-            }
-        };
-        // step up, down, left, or right
-        void step(int magnitude = 1) {
-            int choice = rand() % 4;
-            if (choice == 0) {
-                mX = mX + magnitude;
-            } else if (choice == 1) {
-                mX = mX - magnitude;
-            } else if (choice == 2) {
-                mY = mY + magnitude;
-            } else {
-                mY = mY - magnitude;
-            }
-        }
-        // step in any direction - up, down, left, right, and diagonals
-        void step8(int magnitude = 1) {
-            int choice = rand() % 8;
-            if (choice == 0) {
-                mX = mX + magnitude;
-            } else if (choice == 1) {
-                mX = mX - magnitude;
-            } else if (choice == 2) {
-                mY = mY + magnitude;
-            } else if (choice == 3) {
-                mY = mY - magnitude;
-            } else if (choice == 4) {
-                mX = mX + magnitude;
-                mY = mY + magnitude;
-            } else if (choice == 5) {
-                mX = mX - magnitude;
-                mY = mY + magnitude;
-            } else if (choice == 6) {
-                mX = mX + magnitude;
-                mY = mY - magnitude;
-            } else {
-                mX = mX - magnitude;
-                mY = mY - magnitude;
-            }
-        }
-        void perlinStep(float step_size = 0.01) {
-            float noiseX = perlin_noise(tx);
-            float noiseY = perlin_noise(ty);
-            mX = map(perlin_noise(tx), 0, 1, 0, mWindowWidth);
-            mY = map(perlin_noise(ty), 0, 1, 0, mWindowHeight);
-            tx += step_size;
-            ty += step_size;
-            if (tx > 1e6) {
-                tx = 0.01;
-            }
-            if (ty > 1e6) {
-                ty = 1000;
-            }
-        }
-};
-
 int main( int argc, char* args[] )
 {
-    srand(2178);
-    bool quit = false;
-    SDL_Event e;
+    // fixed seed, so every run replays the same walks
+    Rng rng(2178);
+    SketchOptions options;
+    if (!parseSketchOptions(argc, args, options)) {
+        return 1;
+    }
     SDLWindow window;
     SDL_Renderer* renderer;
-    // initialize SDL
-    if (!window.init(600, 520)) {
+    // initialize SDL (a window, or a CPU framebuffer when headless)
+    if (!window.init(600, 520, !options.uncapped,
+                     options.headless ? BACKEND_HEADLESS : BACKEND_WINDOW)) {
         printf("Failed to initialize\n");
         return 1;
     }
     renderer = window.getRenderer();
 
-    RandomWalker walker_red = RandomWalker(
+    // one noise lattice shared by every walker
+    NoiseLattice lattice(2178);
+
+    // each walker owns its noise handle and rng, so they update independently
+    std::vector<RandomWalker> walkers;
+    walkers.push_back(RandomWalker(
         window.width()/3, window.height()/2, SDL_COL_RED,
-        window.height(), window.width()
-    );
-    RandomWalker walker_grn = RandomWalker(
+        window.height(), window.width(), Noise(lattice, 0), rng.split()
+    ));
+    walkers.push_back(RandomWalker(
         2*window.width()/3, window.height()/2, SDL_COL_GREEN,
-        window.height(), window.width()
-    );
-    RandomWalker walker_blu = RandomWalker(
+        window.height(), window.width(), Noise(lattice, 1), rng.split()
+    ));
+    walkers.push_back(RandomWalker(
         window.width()/2, window.height()/3, SDL_COL_BLUE,
-        window.height(), window.width()
-    );
-
-    // clear screen once
-    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-    SDL_RenderClear(renderer);
+        window.height(), window.width(), Noise(lattice, 2), rng.split()
+    ));
+    walkers[0].setMode(STEP_4, 2);
+    walkers[1].setMode(STEP_8, 2);
+    walkers[2].setMode(STEP_PERLIN, 0.005);
+    JobSystem jobs;
+
+    // trails build up offscreen, the window is redrawn from it every frame
+    TrailBuffer trails;
+    if (!trails.init(renderer, window.width(), window.height(), SDL_COL_WHITE)) {
+        return 1;
+    }
 
-    while (!quit) {
-        while (SDL_PollEvent(&e) != 0) {
-            if (e.type == SDL_QUIT) {
-                quit = true;
-            } else {
-                // handle events
+    // positions reached since the last frame, added to the trails
+    std::vector<SDL_Point> trail;
+    std::vector<SDL_Color> trail_colors;
+    // positions before the last tick, to draw the walkers in between
+    std::vector<Vec2> previous;
+    for (RandomWalker& walker : walkers) {
+        previous.push_back(Vec2(walker.x(), walker.y()));
+    }
+    // every walker is the same circle, so they're all stamped from one sprite
+    SpriteCache sprites(renderer);
+
+    const int tick_rate = 60;
+    Loop loop(window, tick_rate);
+    loop.setUncapped(options.uncapped);
+    loop.setMaxFrames(options.frames);
+    FrameCapture capture;
+    if (!options.capturePath.empty()) {
+        // headless runs wait for the writer rather than drop frames
+        if (!capture.open(options.capturePath, captureFormatFromPath(options.capturePath),
+                          window.width(), window.height(), tick_rate, options.headless)) {
+            return 1;
+        }
+        loop.setCapture(&capture);
+    }
+    if (!options.tracePath.empty()) {
+        Profiler::get().startTrace(options.tracePath);
+    }
+    Profiler::get().setOverlay(options.overlay);
+    loop.onEvent([&](const SDL_Event& event) {
+        if (event.type == SDL_RENDER_DEVICE_RESET) {
+            sprites.clear();
+        }
+        trails.handleEvent(event);
+    });
+    loop.run(
+        [&](double) {
+            for (size_t i = 0; i < walkers.size(); i++) {
+                previous[i] = Vec2(walkers[i].x(), walkers[i].y());
+            }
+            // update shapes (spread across cores)
+            jobs.parallelFor(0, (int)walkers.size(), 256, [&](int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    walkers[i].update();
+                }
+            });
+            for (RandomWalker& walker : walkers) {
+                trail.push_back(walker.pixel());
+                trail_colors.push_back(walker.color());
+            }
+        },
+        [&](double alpha) {
+            // add the new positions to the trails (SDL stays on this thread)
+            trails.begin();
+            sprites.drawCircles(trail.data(), trail_colors.data(), (int)trail.size(),
+                                walkers[0].radius(), SDL_COL_BLACK, walkers[0].filled());
+            trails.end();
+            trail.clear();
+            trail_colors.clear();
+            trails.present();
+            // the walkers themselves between the last two ticks, over the trails
+            for (size_t i = 0; i < walkers.size(); i++) {
+                const float x = lerp((float)alpha, previous[i].x, walkers[i].x());
+                const float y = lerp((float)alpha, previous[i].y, walkers[i].y());
+                sprites.drawCircle((int)lrintf(x), (int)lrintf(y), walkers[i].radius(),
+                                   walkers[i].color(), walkers[i].filled());
             }
         }
-        // update shapes
-        walker_red.step(2);
-        walker_grn.step8(2);
-        walker_blu.perlinStep(0.005);
-        // draw shapes
-        walker_red.draw(renderer);
-        walker_grn.draw(renderer);
-        walker_blu.draw(renderer);
-        // update screen
-        SDL_RenderPresent(renderer);
-        SDL_Delay(10);
+    );
+    if (options.uncapped) {
+        loop.printStats();
+        sprites.printStats();
+    }
+    if (!options.savePath.empty()) {
+        window.saveFrame(options.savePath);
+    }
+    if (capture.isOpen()) {
+        capture.close();
+        capture.printStats();
+    }
+    if (!options.tracePath.empty()) {
+        Profiler::get().stopTrace();
     }
+#ifdef NOC_PROFILE
+    Profiler::get().printSummary();
+#endif
 
     window.close();
 }
@@ -0,0 +1,352 @@
+#include <SDL2/SDL.h>
+#include <math.h>
+#include "noise.hpp"
+#include "random.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NOISE_X86 1
+#endif
+
+// NOTE: the scalar and SIMD paths only match bit for bit if the compiler
+// keeps every multiply and add separate - build with -ffp-contract=off when
+// targeting cpus with FMA (e.g. -march=native).
+
+
+// 0.5 * (1 - cos(pi * t)) for t in [0, 1], written as
+// 0.5 + 0.5 * sin(pi * (t - 0.5)) with a fixed odd polynomial for sin
+// (max error ~6e-8), so the SIMD lanes can reproduce it exactly
+static const float SC_PI = 3.14159265358979f;
+static const float SC_S3 = -1.0f / 6.0f;
+static const float SC_S5 = 1.0f / 120.0f;
+static const float SC_S7 = -1.0f / 5040.0f;
+static const float SC_S9 = 1.0f / 362880.0f;
+static const float SC_S11 = -1.0f / 39916800.0f;
+
+static inline float scaledCosine(float t) {
+    const float p = (t - 0.5f) * SC_PI;
+    const float p2 = p * p;
+    float s = SC_S11;
+    s = s * p2 + SC_S9;
+    s = s * p2 + SC_S7;
+    s = s * p2 + SC_S5;
+    s = s * p2 + SC_S3;
+    s = s * p2 + 1.0f;
+    return 0.5f + 0.5f * (p * s);
+}
+
+static float perlinNoise(const float* lattice, int offset, float x, float y, float z) {
+    const int perlin_ywrap = 1 << PERLIN_YWRAPB;
+    const int perlin_zwrap = 1 << PERLIN_ZWRAPB;
+
+    int xi = (int)floorf(x);
+    float xf = x - xi;
+    int yi = (int)floorf(y);
+    float yf = y - yi;
+    int zi = (int)floorf(z);
+    float zf = z - zi;
+
+    float r = 0, ampl = 0.5f;
+    float rxf, ryf;
+    int of;
+    float n1, n2, n3;
+
+    for (int i = 0; i < PERLIN_OCTAVES; i++) {
+        of = xi + (yi << PERLIN_YWRAPB) + (zi << PERLIN_ZWRAPB) + offset;
+
+        rxf = scaledCosine(xf);
+        ryf = scaledCosine(yf);
+
+        n1 = lattice[of & PERLIN_SIZE];
+        n1 += rxf * (lattice[(of + 1) & PERLIN_SIZE] - n1);
+        n2 = lattice[(of + perlin_ywrap) & PERLIN_SIZE];
+        n2 += rxf * (lattice[(of + perlin_ywrap + 1) & PERLIN_SIZE] - n2);
+        n1 += ryf * (n2 - n1);
+
+        of += perlin_zwrap;
+        n2 = lattice[of & PERLIN_SIZE];
+        n2 += rxf * (lattice[(of + 1) & PERLIN_SIZE] - n2);
+        n3 = lattice[(of + perlin_ywrap) & PERLIN_SIZE];
+        n3 += rxf * (lattice[(of + perlin_ywrap + 1) & PERLIN_SIZE] - n3);
+        n2 += ryf * (n3 - n2);
+
+        n1 += scaledCosine(zf) * (n2 - n1);
+
+        r += n1 * ampl;
+        ampl *= PERLIN_AMP_FALLOFF;
+        xi <<= 1;
+        xf *= 2;
+        yi <<= 1;
+        yf *= 2;
+        zi <<= 1;
+        zf *= 2;
+
+        if (xf >= 1.0f) {
+            xi++;
+            xf--;
+        }
+        if (yf >= 1.0f) {
+            yi++;
+            yf--;
+        }
+        if (zf >= 1.0f) {
+            zi++;
+            zf--;
+        }
+    }
+    return r;
+}
+
+static void batchScalar(const float* lattice, int offset, const float* x, const float* y, const float* z,
+                        float* out, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        out[i] = perlinNoise(lattice, offset, x[i], y ? y[i] : 0, z ? z[i] : 0);
+    }
+}
+
+
+#ifdef NOISE_X86
+
+// SSE2 (4 lanes) - no gather instruction, so lattice reads go through memory
+static inline __m128 scaledCosine4(__m128 t) {
+    const __m128 p = _mm_mul_ps(_mm_sub_ps(t, _mm_set1_ps(0.5f)), _mm_set1_ps(SC_PI));
+    const __m128 p2 = _mm_mul_ps(p, p);
+    __m128 s = _mm_set1_ps(SC_S11);
+    s = _mm_add_ps(_mm_mul_ps(s, p2), _mm_set1_ps(SC_S9));
+    s = _mm_add_ps(_mm_mul_ps(s, p2), _mm_set1_ps(SC_S7));
+    s = _mm_add_ps(_mm_mul_ps(s, p2), _mm_set1_ps(SC_S5));
+    s = _mm_add_ps(_mm_mul_ps(s, p2), _mm_set1_ps(SC_S3));
+    s = _mm_add_ps(_mm_mul_ps(s, p2), _mm_set1_ps(1.0f));
+    const __m128 half = _mm_set1_ps(0.5f);
+    return _mm_add_ps(half, _mm_mul_ps(half, _mm_mul_ps(p, s)));
+}
+
+static inline __m128 gather4(const float* lattice, __m128i index) {
+    alignas(16) int idx[4];
+    _mm_store_si128((__m128i*)idx, _mm_and_si128(index, _mm_set1_epi32(PERLIN_SIZE)));
+    return _mm_setr_ps(lattice[idx[0]], lattice[idx[1]], lattice[idx[2]], lattice[idx[3]]);
+}
+
+// floor for |v| < 2^31 using truncation (SSE2 has no round instruction)
+static inline __m128i floor4(__m128 v) {
+    __m128i t = _mm_cvttps_epi32(v);
+    const __m128 above = _mm_cmpgt_ps(_mm_cvtepi32_ps(t), v);
+    return _mm_add_epi32(t, _mm_castps_si128(above)); // mask is -1 where truncation rounded up
+}
+
+// wrap fractions that reached 1 into the integer part
+static inline void carry4(__m128i& vi, __m128& vf) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 ge = _mm_cmpge_ps(vf, one);
+    vi = _mm_sub_epi32(vi, _mm_castps_si128(ge));
+    vf = _mm_sub_ps(vf, _mm_and_ps(ge, one));
+}
+
+static void batchSSE2(const float* lattice, int offset, const float* x, const float* y, const float* z,
+                      float* out, int n) {
+    const __m128i ywrap = _mm_set1_epi32(1 << PERLIN_YWRAPB);
+    const __m128i zwrap = _mm_set1_epi32(1 << PERLIN_ZWRAPB);
+    const __m128i one_i = _mm_set1_epi32(1);
+    const __m128i offset_i = _mm_set1_epi32(offset);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 vx = _mm_loadu_ps(x + i);
+        const __m128 vy = y ? _mm_loadu_ps(y + i) : _mm_setzero_ps();
+        const __m128 vz = z ? _mm_loadu_ps(z + i) : _mm_setzero_ps();
+        __m128i xi = floor4(vx);
+        __m128 xf = _mm_sub_ps(vx, _mm_cvtepi32_ps(xi));
+        __m128i yi = floor4(vy);
+        __m128 yf = _mm_sub_ps(vy, _mm_cvtepi32_ps(yi));
+        __m128i zi = floor4(vz);
+        __m128 zf = _mm_sub_ps(vz, _mm_cvtepi32_ps(zi));
+
+        __m128 r = _mm_setzero_ps();
+        __m128 ampl = _mm_set1_ps(0.5f);
+        for (int o = 0; o < PERLIN_OCTAVES; o++) {
+            __m128i of = _mm_add_epi32(xi, _mm_add_epi32(_mm_slli_epi32(yi, PERLIN_YWRAPB),
+                                                         _mm_slli_epi32(zi, PERLIN_ZWRAPB)));
+            of = _mm_add_epi32(of, offset_i);
+            const __m128 rxf = scaledCosine4(xf);
+            const __m128 ryf = scaledCosine4(yf);
+            __m128 n1, n2, n3;
+
+            n1 = gather4(lattice, of);
+            n1 = _mm_add_ps(n1, _mm_mul_ps(rxf, _mm_sub_ps(gather4(lattice, _mm_add_epi32(of, one_i)), n1)));
+            n2 = gather4(lattice, _mm_add_epi32(of, ywrap));
+            n2 = _mm_add_ps(n2, _mm_mul_ps(rxf, _mm_sub_ps(gather4(lattice, _mm_add_epi32(_mm_add_epi32(of, ywrap), one_i)), n2)));
+            n1 = _mm_add_ps(n1, _mm_mul_ps(ryf, _mm_sub_ps(n2, n1)));
+
+            of = _mm_add_epi32(of, zwrap);
+            n2 = gather4(lattice, of);
+            n2 = _mm_add_ps(n2, _mm_mul_ps(rxf, _mm_sub_ps(gather4(lattice, _mm_add_epi32(of, one_i)), n2)));
+            n3 = gather4(lattice, _mm_add_epi32(of, ywrap));
+            n3 = _mm_add_ps(n3, _mm_mul_ps(rxf, _mm_sub_ps(gather4(lattice, _mm_add_epi32(_mm_add_epi32(of, ywrap), one_i)), n3)));
+            n2 = _mm_add_ps(n2, _mm_mul_ps(ryf, _mm_sub_ps(n3, n2)));
+
+            n1 = _mm_add_ps(n1, _mm_mul_ps(scaledCosine4(zf), _mm_sub_ps(n2, n1)));
+
+            r = _mm_add_ps(r, _mm_mul_ps(n1, ampl));
+            ampl = _mm_mul_ps(ampl, _mm_set1_ps(PERLIN_AMP_FALLOFF));
+            xi = _mm_slli_epi32(xi, 1);
+            xf = _mm_add_ps(xf, xf);
+            yi = _mm_slli_epi32(yi, 1);
+            yf = _mm_add_ps(yf, yf);
+            zi = _mm_slli_epi32(zi, 1);
+            zf = _mm_add_ps(zf, zf);
+            carry4(xi, xf);
+            carry4(yi, yf);
+            carry4(zi, zf);
+        }
+        _mm_storeu_ps(out + i, r);
+    }
+    batchScalar(lattice, offset, x, y, z, out, i, n);
+}
+
+
+// AVX2 (8 lanes) with hardware gathers; compiled for avx2 only (not fma)
+#define NOISE_AVX2_FN __attribute__((target("avx2")))
+
+NOISE_AVX2_FN static inline __m256 scaledCosine8(__m256 t) {
+    const __m256 p = _mm256_mul_ps(_mm256_sub_ps(t, _mm256_set1_ps(0.5f)), _mm256_set1_ps(SC_PI));
+    const __m256 p2 = _mm256_mul_ps(p, p);
+    __m256 s = _mm256_set1_ps(SC_S11);
+    s = _mm256_add_ps(_mm256_mul_ps(s, p2), _mm256_set1_ps(SC_S9));
+    s = _mm256_add_ps(_mm256_mul_ps(s, p2), _mm256_set1_ps(SC_S7));
+    s = _mm256_add_ps(_mm256_mul_ps(s, p2), _mm256_set1_ps(SC_S5));
+    s = _mm256_add_ps(_mm256_mul_ps(s, p2), _mm256_set1_ps(SC_S3));
+    s = _mm256_add_ps(_mm256_mul_ps(s, p2), _mm256_set1_ps(1.0f));
+    const __m256 half = _mm256_set1_ps(0.5f);
+    return _mm256_add_ps(half, _mm256_mul_ps(half, _mm256_mul_ps(p, s)));
+}
+
+NOISE_AVX2_FN static inline __m256 gather8(const float* lattice, __m256i index) {
+    return _mm256_i32gather_ps(lattice, _mm256_and_si256(index, _mm256_set1_epi32(PERLIN_SIZE)), 4);
+}
+
+NOISE_AVX2_FN static inline void carry8(__m256i& vi, __m256& vf) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 ge = _mm256_cmp_ps(vf, one, _CMP_GE_OQ);
+    vi = _mm256_sub_epi32(vi, _mm256_castps_si256(ge));
+    vf = _mm256_sub_ps(vf, _mm256_and_ps(ge, one));
+}
+
+NOISE_AVX2_FN static void batchAVX2(const float* lattice, int offset, const float* x, const float* y, const float* z,
+                                    float* out, int n) {
+    const __m256i ywrap = _mm256_set1_epi32(1 << PERLIN_YWRAPB);
+    const __m256i zwrap = _mm256_set1_epi32(1 << PERLIN_ZWRAPB);
+    const __m256i one_i = _mm256_set1_epi32(1);
+    const __m256i offset_i = _mm256_set1_epi32(offset);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 vx = _mm256_loadu_ps(x + i);
+        const __m256 vy = y ? _mm256_loadu_ps(y + i) : _mm256_setzero_ps();
+        const __m256 vz = z ? _mm256_loadu_ps(z + i) : _mm256_setzero_ps();
+        __m256i xi = _mm256_cvttps_epi32(_mm256_floor_ps(vx));
+        __m256 xf = _mm256_sub_ps(vx, _mm256_cvtepi32_ps(xi));
+        __m256i yi = _mm256_cvttps_epi32(_mm256_floor_ps(vy));
+        __m256 yf = _mm256_sub_ps(vy, _mm256_cvtepi32_ps(yi));
+        __m256i zi = _mm256_cvttps_epi32(_mm256_floor_ps(vz));
+        __m256 zf = _mm256_sub_ps(vz, _mm256_cvtepi32_ps(zi));
+
+        __m256 r = _mm256_setzero_ps();
+        __m256 ampl = _mm256_set1_ps(0.5f);
+        for (int o = 0; o < PERLIN_OCTAVES; o++) {
+            __m256i of = _mm256_add_epi32(xi, _mm256_add_epi32(_mm256_slli_epi32(yi, PERLIN_YWRAPB),
+                                                               _mm256_slli_epi32(zi, PERLIN_ZWRAPB)));
+            of = _mm256_add_epi32(of, offset_i);
+            const __m256 rxf = scaledCosine8(xf);
+            const __m256 ryf = scaledCosine8(yf);
+            __m256 n1, n2, n3;
+
+            n1 = gather8(lattice, of);
+            n1 = _mm256_add_ps(n1, _mm256_mul_ps(rxf, _mm256_sub_ps(gather8(lattice, _mm256_add_epi32(of, one_i)), n1)));
+            n2 = gather8(lattice, _mm256_add_epi32(of, ywrap));
+            n2 = _mm256_add_ps(n2, _mm256_mul_ps(rxf, _mm256_sub_ps(gather8(lattice, _mm256_add_epi32(_mm256_add_epi32(of, ywrap), one_i)), n2)));
+            n1 = _mm256_add_ps(n1, _mm256_mul_ps(ryf, _mm256_sub_ps(n2, n1)));
+
+            of = _mm256_add_epi32(of, zwrap);
+            n2 = gather8(lattice, of);
+            n2 = _mm256_add_ps(n2, _mm256_mul_ps(rxf, _mm256_sub_ps(gather8(lattice, _mm256_add_epi32(of, one_i)), n2)));
+            n3 = gather8(lattice, _mm256_add_epi32(of, ywrap));
+            n3 = _mm256_add_ps(n3, _mm256_mul_ps(rxf, _mm256_sub_ps(gather8(lattice, _mm256_add_epi32(_mm256_add_epi32(of, ywrap), one_i)), n3)));
+            n2 = _mm256_add_ps(n2, _mm256_mul_ps(ryf, _mm256_sub_ps(n3, n2)));
+
+            n1 = _mm256_add_ps(n1, _mm256_mul_ps(scaledCosine8(zf), _mm256_sub_ps(n2, n1)));
+
+            r = _mm256_add_ps(r, _mm256_mul_ps(n1, ampl));
+            ampl = _mm256_mul_ps(ampl, _mm256_set1_ps(PERLIN_AMP_FALLOFF));
+            xi = _mm256_slli_epi32(xi, 1);
+            xf = _mm256_add_ps(xf, xf);
+            yi = _mm256_slli_epi32(yi, 1);
+            yf = _mm256_add_ps(yf, yf);
+            zi = _mm256_slli_epi32(zi, 1);
+            zf = _mm256_add_ps(zf, zf);
+            carry8(xi, xf);
+            carry8(yi, yf);
+            carry8(zi, zf);
+        }
+        _mm256_storeu_ps(out + i, r);
+    }
+    batchScalar(lattice, offset, x, y, z, out, i, n);
+}
+
+#endif // NOISE_X86
+
+
+NoisePath noiseBestPath() {
+#ifdef NOISE_X86
+    static const NoisePath best = SDL_HasAVX2() ? NOISE_AVX2 : (SDL_HasSSE2() ? NOISE_SSE2 : NOISE_SCALAR);
+    return best;
+#else
+    return NOISE_SCALAR;
+#endif
+}
+
+const char* noisePathName(NoisePath path) {
+    switch (path) {
+        case NOISE_AUTO: return "auto";
+        case NOISE_SCALAR: return "scalar";
+        case NOISE_SSE2: return "sse2";
+        case NOISE_AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+// NOISE LATTICE
+NoiseLattice::NoiseLattice(unsigned int seed) : mSeed(seed) {
+    Rng rng(seed);
+    for (int i = 0; i <= PERLIN_SIZE; i++) {
+        mValues[i] = rng.uniform();
+    }
+}
+
+
+// NOISE
+Noise::Noise(const NoiseLattice& lattice, unsigned int stream) : mLattice(&lattice) {
+    // stream 0 reads the lattice as is; others start at a hashed offset
+    Uint64 state = stream;
+    mOffset = stream == 0 ? 0 : (int)(splitmix64(state) & PERLIN_SIZE);
+}
+
+float Noise::sample(float x, float y, float z) const {
+    return perlinNoise(mLattice->values(), mOffset, x, y, z);
+}
+
+void Noise::sampleBatch(const float* x, const float* y, const float* z,
+                        float* out, int n, NoisePath path) const {
+    const float* lattice = mLattice->values();
+    if (path == NOISE_AUTO) {
+        path = noiseBestPath();
+    }
+#ifdef NOISE_X86
+    if (path == NOISE_AVX2) {
+        batchAVX2(lattice, mOffset, x, y, z, out, n);
+        return;
+    }
+    if (path == NOISE_SSE2) {
+        batchSSE2(lattice, mOffset, x, y, z, out, n);
+        return;
+    }
+#endif
+    batchScalar(lattice, mOffset, x, y, z, out, 0, n);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+
+// p5.js style value noise: 4 octaves over a 4096 entry lattice of floats
+// https://github.com/processing/p5.js/blob/33883e5a326fcc3c1ba73a50d74b910af077a688/src/math/noise.js#L254
+
+const int PERLIN_SIZE = 4095; // lattice index mask (lattice holds PERLIN_SIZE + 1 values)
+const int PERLIN_YWRAPB = 4;
+const int PERLIN_ZWRAPB = 8;
+const int PERLIN_OCTAVES = 4;
+const float PERLIN_AMP_FALLOFF = 0.5f;
+
+// which code path a batch is evaluated with
+enum NoisePath {
+    NOISE_AUTO,   // best path this cpu supports
+    NOISE_SCALAR,
+    NOISE_SSE2,
+    NOISE_AVX2
+};
+
+// Immutable lattice of noise values, filled deterministically from a seed.
+// It is 16 KB, so build one and share it between all Noise handles rather
+// than giving every walker its own copy.
+class NoiseLattice {
+    private:
+        float mValues[PERLIN_SIZE + 1];
+        unsigned int mSeed;
+    public:
+        NoiseLattice(unsigned int seed);
+        const float* values() const { return mValues; }
+        unsigned int seed() const { return mSeed; }
+};
+
+// Lightweight view of a shared lattice (a pointer and an offset).
+// Handles built with different streams read the lattice at different
+// offsets, so walkers sharing one lattice still move independently.
+class Noise {
+    private:
+        const NoiseLattice* mLattice;
+        int mOffset;
+    public:
+        Noise(const NoiseLattice& lattice, unsigned int stream = 0);
+        // single sample
+        float sample(float x, float y = 0, float z = 0) const;
+        // n samples at (x[i], y[i], z[i]); y or z may be NULL to sample at 0
+        // - every path gives bit for bit the same results as sample()
+        void sampleBatch(const float* x, const float* y, const float* z,
+                         float* out, int n, NoisePath path = NOISE_AUTO) const;
+};
+
+NoisePath noiseBestPath();
+const char* noisePathName(NoisePath path);
@@ -0,0 +1,224 @@
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <vector>
+#include "particles.hpp"
+#include "utils.hpp"
+
+
+void ParticleSystem::reserve(int count) {
+    mX.reserve(count);
+    mY.reserve(count);
+    mPrevX.reserve(count);
+    mPrevY.reserve(count);
+    mVX.reserve(count);
+    mVY.reserve(count);
+    mAX.reserve(count);
+    mAY.reserve(count);
+    mInvMass.reserve(count);
+    mRadius.reserve(count);
+    mColor.reserve(count);
+    mSlots.reserve(count);
+    mDrawn.reserve(count);
+}
+
+int ParticleSystem::add(float x, float y, float vx, float vy, float radius, SDL_Color color, float mass) {
+    mX.push_back(x);
+    mY.push_back(y);
+    mPrevX.push_back(x);
+    mPrevY.push_back(y);
+    mVX.push_back(vx);
+    mVY.push_back(vy);
+    mAX.push_back(0);
+    mAY.push_back(0);
+    mInvMass.push_back(1.0f / mass);
+    mRadius.push_back(radius);
+    mColor.push_back(color);
+    mDrawn.push_back({ 0, 0, 0, 0 });
+    mSlots.insert();
+    return size() - 1;
+}
+
+Handle ParticleSystem::spawn(float x, float y, float vx, float vy, float radius, SDL_Color color, float mass) {
+    return handle(add(x, y, vx, vy, radius, color, mass));
+}
+
+// move the last element into slot i and drop the last
+template <typename T>
+static void swapRemove(std::vector<T>& column, int i) {
+    column[i] = column.back();
+    column.pop_back();
+}
+
+bool ParticleSystem::kill(Handle handle) {
+    const int i = mSlots.erase(handle);
+    if (i < 0) {
+        return false;
+    }
+    swapRemove(mX, i);
+    swapRemove(mY, i);
+    swapRemove(mPrevX, i);
+    swapRemove(mPrevY, i);
+    swapRemove(mVX, i);
+    swapRemove(mVY, i);
+    swapRemove(mAX, i);
+    swapRemove(mAY, i);
+    swapRemove(mInvMass, i);
+    swapRemove(mRadius, i);
+    swapRemove(mColor, i);
+    if (mTracking && mDrawn[i].w > 0) {
+        mVacated.push_back(mDrawn[i]);
+    }
+    swapRemove(mDrawn, i);
+    return true;
+}
+
+void ParticleSystem::clear() {
+    mX.clear();
+    mY.clear();
+    mPrevX.clear();
+    mPrevY.clear();
+    mVX.clear();
+    mVY.clear();
+    mAX.clear();
+    mAY.clear();
+    mInvMass.clear();
+    mRadius.clear();
+    mColor.clear();
+    mSlots.clear();
+    for (const SDL_Rect& r : mDrawn) {
+        if (mTracking && r.w > 0) {
+            mVacated.push_back(r);
+        }
+    }
+    mDrawn.clear();
+}
+
+// work is split into chunks of this many particles across threads
+static const int PARTICLE_GRAIN = 16384;
+
+MoverArrays ParticleSystem::movers() {
+    return { mX.data(), mY.data(), mPrevX.data(), mPrevY.data(), mVX.data(), mVY.data(),
+             mAX.data(), mAY.data(), mInvMass.data(), mRadius.data() };
+}
+
+void ParticleSystem::applyForce(float fx, float fy) {
+    ::applyForce(movers(), fx, fy, 0, size());
+}
+
+void ParticleSystem::applyAcceleration(float gx, float gy) {
+    ::applyAcceleration(movers(), gx, gy, 0, size());
+}
+
+void ParticleSystem::applyDrag(float c) {
+    ::applyDrag(movers(), c, 0, size());
+}
+
+void ParticleSystem::integrate(float dt, Integrator integrator) {
+    ::integrate(movers(), integrator, dt, 0, size());
+}
+
+void ParticleSystem::integrate(float dt, Integrator integrator, JobSystem& jobs) {
+    const MoverArrays m = movers();
+    jobs.parallelFor(0, size(), PARTICLE_GRAIN, [&](int begin, int end) {
+        ::integrate(m, integrator, dt, begin, end);
+    });
+}
+
+void ParticleSystem::constrain(Boundary boundary, int width, int height, float restitution) {
+    ::constrain(movers(), boundary, (float)width, (float)height, restitution, 0, size());
+}
+
+void ParticleSystem::constrain(Boundary boundary, int width, int height, float restitution, JobSystem& jobs) {
+    const MoverArrays m = movers();
+    jobs.parallelFor(0, size(), PARTICLE_GRAIN, [&](int begin, int end) {
+        ::constrain(m, boundary, (float)width, (float)height, restitution, begin, end);
+    });
+}
+
+void ParticleSystem::update(float dt) {
+    integrate(dt, INTEGRATE_EULER);
+}
+
+void ParticleSystem::update(float dt, JobSystem& jobs) {
+    integrate(dt, INTEGRATE_EULER, jobs);
+}
+
+void ParticleSystem::wrap(int width, int height) {
+    constrain(BOUNDARY_WRAP, width, height);
+}
+
+void ParticleSystem::wrap(int width, int height, JobSystem& jobs) {
+    constrain(BOUNDARY_WRAP, width, height, 1.0f, jobs);
+}
+
+void ParticleSystem::draw(SDL_Renderer* renderer, float alpha) {
+    const int n = size();
+    int i = 0;
+    // one submission per run of same-colored particles
+    while (i < n) {
+        const SDL_Color c = mColor[i];
+        int end = i;
+        mSpans.clear();
+        mPoints.clear();
+        while (end < n && mColor[end].r == c.r && mColor[end].g == c.g &&
+               mColor[end].b == c.b && mColor[end].a == c.a) {
+            const int cx = (int)lrintf(mPrevX[end] + alpha * (mX[end] - mPrevX[end]));
+            const int cy = (int)lrintf(mPrevY[end] + alpha * (mY[end] - mPrevY[end]));
+            const int radius = (int)lrintf(mRadius[end]);
+            if (mFillFlag) {
+                circleSpans(cx, cy, radius, mSpans);
+            } else {
+                circleOutline(cx, cy, radius, mPoints);
+            }
+            end++;
+        }
+        SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+        if (mFillFlag) {
+            SDL_RenderFillRects(renderer, mSpans.data(), (int)mSpans.size());
+        } else {
+            SDL_RenderDrawPoints(renderer, mPoints.data(), (int)mPoints.size());
+        }
+        i = end;
+    }
+}
+
+void ParticleSystem::draw(SpriteCache& sprites, float alpha) {
+    const int n = size();
+    int i = 0;
+    while (i < n) {
+        const int radius = (int)lrintf(mRadius[i]);
+        int end = i;
+        mPoints.clear();
+        mColors.clear();
+        while (end < n && (int)lrintf(mRadius[end]) == radius) {
+            const int cx = (int)lrintf(mPrevX[end] + alpha * (mX[end] - mPrevX[end]));
+            const int cy = (int)lrintf(mPrevY[end] + alpha * (mY[end] - mPrevY[end]));
+            mPoints.push_back({ cx, cy });
+            mColors.push_back(mColor[end]);
+            end++;
+        }
+        sprites.drawCircles(mPoints.data(), mColors.data(), (int)mPoints.size(),
+                            radius, mColor[i], mFillFlag);
+        i = end;
+    }
+}
+
+void ParticleSystem::damage(DamageTracker& tracker, float alpha) {
+    mTracking = true;
+    for (const SDL_Rect& r : mVacated) {
+        tracker.add(r);
+    }
+    mVacated.clear();
+    const int n = size();
+    for (int i = 0; i < n; i++) {
+        const int cx = (int)lrintf(mPrevX[i] + alpha * (mX[i] - mPrevX[i]));
+        const int cy = (int)lrintf(mPrevY[i] + alpha * (mY[i] - mPrevY[i]));
+        const SDL_Rect now = circleBounds(cx, cy, (int)lrintf(mRadius[i]));
+        if (mDrawn[i].w > 0) {
+            tracker.moved(mDrawn[i], now);
+        } else {
+            tracker.add(now);
+        }
+        mDrawn[i] = now;
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+#include <SDL2/SDL.h>
+#include "jobs.hpp"
+#include "sprites.hpp"
+#include "physics.hpp"
+#include "pool.hpp"
+#include "damage.hpp"
+
+
+// Many moving circles stored as structure-of-arrays, so the update loop
+// walks contiguous floats (and vectorizes) instead of hopping between
+// separate Polygon objects. Particles can also be spawned and killed
+// through stable handles; killing one moves the last particle into its
+// place, so the columns stay dense.
+class ParticleSystem {
+    private:
+        std::vector<float> mX;
+        std::vector<float> mY;
+        std::vector<float> mPrevX; // position before the last update, for interpolation
+        std::vector<float> mPrevY;
+        std::vector<float> mVX;
+        std::vector<float> mVY;
+        std::vector<float> mAX; // acceleration accumulated until the next integrate()
+        std::vector<float> mAY;
+        std::vector<float> mInvMass;
+        std::vector<float> mRadius;
+        std::vector<SDL_Color> mColor;
+        SlotMap mSlots;
+        // damage tracking: where each particle was last drawn, and the
+        // spots of particles killed since (only once damage() is in use)
+        std::vector<SDL_Rect> mDrawn;
+        std::vector<SDL_Rect> mVacated;
+        bool mTracking = false;
+        bool mFillFlag = true;
+        // draw scratch, reused between frames
+        std::vector<SDL_Rect> mSpans;
+        std::vector<SDL_Point> mPoints;
+        std::vector<SDL_Color> mColors;
+        MoverArrays movers();
+    public:
+        ParticleSystem() {};
+        void reserve(int count);
+        int add(float x, float y, float vx, float vy, float radius, SDL_Color color, float mass = 1.0f);
+        // like add(), but returns a handle that survives other particles dying
+        Handle spawn(float x, float y, float vx, float vy, float radius, SDL_Color color, float mass = 1.0f);
+        // O(1), false if the handle was already dead
+        bool kill(Handle handle);
+        bool alive(Handle handle) const { return mSlots.alive(handle); }
+        // current column index of a live particle, -1 otherwise
+        int indexOf(Handle handle) const { return mSlots.index(handle); }
+        Handle handle(int index) const { return mSlots.handle(index); }
+        void clear();
+        int size() { return (int)mX.size(); }
+        void setFill(bool fill) { mFillFlag = fill; };
+        // raw column access for bulk kernels
+        float* x() { return mX.data(); }
+        float* y() { return mY.data(); }
+        float* vx() { return mVX.data(); }
+        float* vy() { return mVY.data(); }
+        // add per-particle forces here (as force / mass) before integrate()
+        float* ax() { return mAX.data(); }
+        float* ay() { return mAY.data(); }
+        float* radius() { return mRadius.data(); }
+        SDL_Color* color() { return mColor.data(); }
+        // forces shared by every particle (see physics.hpp)
+        void applyForce(float fx, float fy);
+        void applyAcceleration(float gx, float gy);
+        void applyDrag(float c);
+        // advance by dt with the chosen integrator, clearing the accumulated acceleration
+        void integrate(float dt, Integrator integrator);
+        void integrate(float dt, Integrator integrator, JobSystem& jobs);
+        void constrain(Boundary boundary, int width, int height, float restitution = 1.0f);
+        void constrain(Boundary boundary, int width, int height, float restitution, JobSystem& jobs);
+        // advance every particle by its velocity (Euler)
+        void update(float dt);
+        void update(float dt, JobSystem& jobs);
+        // move particles that fully left the window back in on the other side
+        void wrap(int width, int height);
+        void wrap(int width, int height, JobSystem& jobs);
+        // alpha blends between the previous and current positions
+        void draw(SDL_Renderer* renderer, float alpha = 1.0f);
+        // stamp cached circle sprites, one batch per run of equal radii
+        void draw(SpriteCache& sprites, float alpha = 1.0f);
+        // report what draw(renderer, alpha) will change since the last call:
+        // moves, spawns and kills (recoloring through color() isn't seen)
+        void damage(DamageTracker& tracker, float alpha = 1.0f);
+};
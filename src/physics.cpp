@@ -0,0 +1,129 @@
+#include <math.h>
+#include "physics.hpp"
+
+
+void applyForce(const MoverArrays& m, float fx, float fy, int begin, int end) {
+    float* __restrict ax = m.ax;
+    float* __restrict ay = m.ay;
+    const float* __restrict inv_mass = m.invMass;
+    for (int i = begin; i < end; i++) {
+        ax[i] += fx * inv_mass[i];
+        ay[i] += fy * inv_mass[i];
+    }
+}
+
+void applyAcceleration(const MoverArrays& m, float gx, float gy, int begin, int end) {
+    float* __restrict ax = m.ax;
+    float* __restrict ay = m.ay;
+    for (int i = begin; i < end; i++) {
+        ax[i] += gx;
+        ay[i] += gy;
+    }
+}
+
+void applyDrag(const MoverArrays& m, float c, int begin, int end) {
+    float* __restrict ax = m.ax;
+    float* __restrict ay = m.ay;
+    const float* __restrict vx = m.vx;
+    const float* __restrict vy = m.vy;
+    const float* __restrict inv_mass = m.invMass;
+    for (int i = begin; i < end; i++) {
+        const float speed = sqrtf(vx[i] * vx[i] + vy[i] * vy[i]);
+        const float k = c * speed * inv_mass[i];
+        ax[i] -= k * vx[i];
+        ay[i] -= k * vy[i];
+    }
+}
+
+
+// one axis of integrate(); restrict parameters (not locals) so gcc can
+// prove the columns don't overlap and vectorize
+static void integrateAxis(float* __restrict p, float* __restrict prev, float* __restrict v,
+                          float* __restrict a, Integrator integrator, float dt, int begin, int end) {
+    // one loop per integrator, so the choice isn't made per mover
+    if (integrator == INTEGRATE_EULER) {
+        for (int i = begin; i < end; i++) {
+            prev[i] = p[i];
+            p[i] += v[i] * dt;
+            v[i] += a[i] * dt;
+            a[i] = 0;
+        }
+    } else if (integrator == INTEGRATE_SEMI_IMPLICIT) {
+        for (int i = begin; i < end; i++) {
+            prev[i] = p[i];
+            v[i] += a[i] * dt;
+            p[i] += v[i] * dt;
+            a[i] = 0;
+        }
+    } else {
+        // Stormer-Verlet, x' = 2x - prev + a dt^2, written with the last
+        // step's velocity (v = (x - prev) / dt) so setting v and the
+        // boundaries keep working
+        const float dt2 = dt * dt;
+        const float inv_dt = 1.0f / dt;
+        for (int i = begin; i < end; i++) {
+            const float step = v[i] * dt + a[i] * dt2;
+            prev[i] = p[i];
+            p[i] += step;
+            v[i] = step * inv_dt;
+            a[i] = 0;
+        }
+    }
+}
+
+void integrate(const MoverArrays& m, Integrator integrator, float dt, int begin, int end) {
+    integrateAxis(m.x, m.prevX, m.vx, m.ax, integrator, dt, begin, end);
+    integrateAxis(m.y, m.prevY, m.vy, m.ay, integrator, dt, begin, end);
+}
+
+
+// one axis of constrain(); selects rather than branches so it vectorizes
+static void constrainAxis(float* __restrict p, float* __restrict prev, float* __restrict v,
+                          const float* __restrict radius, Boundary boundary, float size,
+                          float restitution, int begin, int end) {
+    if (boundary == BOUNDARY_WRAP) {
+        for (int i = begin; i < end; i++) {
+            const float r = radius[i];
+            const float span = size + 2 * r;
+            float shift = (p[i] - r >= size) ? -span : 0.0f;
+            shift = (p[i] + r < 0) ? span : shift;
+            // the previous position moves too, so interpolation doesn't
+            // streak across the window
+            p[i] += shift;
+            prev[i] += shift;
+        }
+    } else if (boundary == BOUNDARY_BOUNCE) {
+        for (int i = begin; i < end; i++) {
+            const float lo = radius[i];
+            const float hi = size - radius[i];
+            // mirror the position (and the previous one) in the wall the
+            // mover crossed: x' = 2 wall - x, or x' = 0 + 1 x if none
+            const float wall = p[i] < lo ? lo : hi;
+            const float hit = (p[i] < lo || p[i] > hi) ? 1.0f : 0.0f;
+            const float flip = 1.0f - 2.0f * hit;
+            float x = 2 * wall * hit + flip * p[i];
+            x = x < lo ? lo : x;
+            x = x > hi ? hi : x;
+            prev[i] = 2 * wall * hit + flip * prev[i];
+            v[i] *= 1.0f - hit * (1.0f + restitution);
+            p[i] = x;
+        }
+    } else if (boundary == BOUNDARY_CLAMP) {
+        for (int i = begin; i < end; i++) {
+            const float lo = radius[i];
+            const float hi = size - radius[i];
+            const float keep = (p[i] < lo || p[i] > hi) ? 0.0f : 1.0f;
+            float x = p[i] < lo ? lo : p[i];
+            x = x > hi ? hi : x;
+            v[i] *= keep;
+            prev[i] = keep * prev[i] + (1.0f - keep) * x;
+            p[i] = x;
+        }
+    }
+}
+
+void constrain(const MoverArrays& m, Boundary boundary, float width, float height,
+               float restitution, int begin, int end) {
+    constrainAxis(m.x, m.prevX, m.vx, m.radius, boundary, width, restitution, begin, end);
+    constrainAxis(m.y, m.prevY, m.vy, m.radius, boundary, height, restitution, begin, end);
+}
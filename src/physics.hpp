@@ -0,0 +1,48 @@
+#pragma once
+
+
+// how positions and velocities advance each tick
+enum Integrator {
+    INTEGRATE_EULER,         // x += v dt, then v += a dt
+    INTEGRATE_SEMI_IMPLICIT, // v += a dt, then x += v dt (symplectic Euler, stable orbits)
+    INTEGRATE_VERLET         // x += (x - prev) + a dt^2, velocity derived from the step
+};
+
+// what happens at the edges of the world
+enum Boundary {
+    BOUNDARY_NONE,
+    BOUNDARY_WRAP,   // leave fully on one side, come back on the other
+    BOUNDARY_BOUNCE, // reflect off the edges, scaled by restitution
+    BOUNDARY_CLAMP   // stop at the edges
+};
+
+// Column pointers into structure-of-arrays mover state (e.g. ParticleSystem).
+// prevX/prevY hold the position before the last step: Verlet integrates
+// from it and renderers interpolate from it.
+struct MoverArrays {
+    float* x;
+    float* y;
+    float* prevX;
+    float* prevY;
+    float* vx;
+    float* vy;
+    float* ax; // accumulated acceleration, cleared by integrate()
+    float* ay;
+    const float* invMass;
+    const float* radius;
+};
+
+// The kernels below work on [begin, end) so they can be split across a
+// JobSystem. They have no branches in their loops, so they vectorize.
+
+// a += f / m, the same force on every mover (wind, a push)
+void applyForce(const MoverArrays& m, float fx, float fy, int begin, int end);
+// a += g, the same acceleration whatever the mass
+void applyAcceleration(const MoverArrays& m, float gx, float gy, int begin, int end);
+// a -= c |v| v / m, quadratic drag
+void applyDrag(const MoverArrays& m, float c, int begin, int end);
+// advance by dt and clear the accumulated acceleration
+void integrate(const MoverArrays& m, Integrator integrator, float dt, int begin, int end);
+// keep movers (treated as circles of their radius) inside width x height
+void constrain(const MoverArrays& m, Boundary boundary, float width, float height,
+               float restitution, int begin, int end);
@@ -0,0 +1,48 @@
+#include <vector>
+#include "pool.hpp"
+
+
+void SlotMap::reserve(int count) {
+    mDense.reserve(count);
+    mGeneration.reserve(count);
+    mSlot.reserve(count);
+}
+
+Handle SlotMap::insert() {
+    int slot = mFreeHead;
+    if (slot >= 0) {
+        mFreeHead = mDense[slot];
+    } else {
+        slot = (int)mDense.size();
+        mDense.push_back(0);
+        mGeneration.push_back(1);
+    }
+    mDense[slot] = (int)mSlot.size();
+    mSlot.push_back(slot);
+    return { slot, mGeneration[slot] };
+}
+
+int SlotMap::erase(Handle handle) {
+    const int i = index(handle);
+    if (i < 0) {
+        return -1;
+    }
+    // the last item takes the hole
+    const int last_slot = mSlot.back();
+    mSlot[i] = last_slot;
+    mDense[last_slot] = i;
+    mSlot.pop_back();
+    // retire the handle (skipping 0, which is never live) and free the slot
+    if (++mGeneration[handle.slot] == 0) {
+        mGeneration[handle.slot] = 1;
+    }
+    mDense[handle.slot] = mFreeHead;
+    mFreeHead = handle.slot;
+    return i;
+}
+
+void SlotMap::clear() {
+    while (!mSlot.empty()) {
+        erase(handle(size() - 1));
+    }
+}
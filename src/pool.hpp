@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+
+// Stable reference to something in a SlotMap/Pool. It stays valid while
+// the item lives, however the items are shuffled; once the item is
+// killed the generation no longer matches and lookups fail.
+struct Handle {
+    int slot = -1;
+    unsigned int generation = 0; // 0 is never live
+    bool operator==(const Handle& h) const { return slot == h.slot && generation == h.generation; }
+    bool operator!=(const Handle& h) const { return !(*this == h); }
+};
+
+// Handle bookkeeping for items kept dense in one or more arrays.
+// insert() always puts the new item at index size() - 1; erase() moves the
+// last item into the hole, so the owner does the same to its arrays:
+//     int i = slots.erase(handle);
+//     if (i >= 0) { items[i] = items.back(); items.pop_back(); }
+// Both are O(1) and, once reserve()d or warmed up, never allocate.
+class SlotMap {
+    private:
+        std::vector<int> mDense;               // slot -> dense index, or next free slot
+        std::vector<unsigned int> mGeneration; // slot -> generation, even when free
+        std::vector<int> mSlot;                // dense index -> slot
+        int mFreeHead = -1;
+    public:
+        SlotMap() {};
+        void reserve(int count);
+        Handle insert();
+        // the dense index the item was at (now holding the last item), or
+        // -1 if the handle was already dead
+        int erase(Handle handle);
+        // dense index of a live handle, -1 otherwise
+        int index(Handle handle) const {
+            if (handle.slot < 0 || handle.slot >= (int)mGeneration.size() ||
+                mGeneration[handle.slot] != handle.generation) {
+                return -1;
+            }
+            return mDense[handle.slot];
+        }
+        bool alive(Handle handle) const { return index(handle) >= 0; }
+        Handle handle(int index) const { return { mSlot[index], mGeneration[mSlot[index]] }; }
+        int size() const { return (int)mSlot.size(); }
+        // kill everything; old handles all go stale, slots are kept
+        void clear();
+};
+
+// Objects kept contiguous for iteration, with O(1) spawn and kill through
+// handles. Killing moves the last object into the hole, so iteration order
+// isn't spawn order.
+template <typename T>
+class Pool {
+    private:
+        std::vector<T> mItems;
+        SlotMap mSlots;
+    public:
+        Pool() {};
+        void reserve(int count) {
+            mItems.reserve(count);
+            mSlots.reserve(count);
+        }
+        Handle spawn(const T& item) {
+            mItems.push_back(item);
+            return mSlots.insert();
+        }
+        // false if the handle was already dead
+        bool kill(Handle handle) {
+            const int i = mSlots.erase(handle);
+            if (i < 0) {
+                return false;
+            }
+            if (i != (int)mItems.size() - 1) {
+                mItems[i] = std::move(mItems.back());
+            }
+            mItems.pop_back();
+            return true;
+        }
+        // NULL once the object is dead (don't keep it across spawn/kill)
+        T* get(Handle handle) {
+            const int i = mSlots.index(handle);
+            return i < 0 ? NULL : &mItems[i];
+        }
+        bool alive(Handle handle) const { return mSlots.alive(handle); }
+        Handle handle(int index) const { return mSlots.handle(index); }
+        void clear() {
+            mItems.clear();
+            mSlots.clear();
+        }
+        int size() const { return (int)mItems.size(); }
+        T* data() { return mItems.data(); }
+        T& operator[](int index) { return mItems[index]; }
+        typename std::vector<T>::iterator begin() { return mItems.begin(); }
+        typename std::vector<T>::iterator end() { return mItems.end(); }
+};
@@ -0,0 +1,157 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "profiler.hpp"
+
+// frames of history kept per phase
+static const int PROFILE_HISTORY = 512;
+// cap on buffered trace events (~32 MB) so a forgotten trace can't eat memory
+static const size_t PROFILE_MAX_EVENTS = 1 << 20;
+
+
+// small stable id per thread for the trace viewer
+static int threadId() {
+    static std::atomic<int> next(0);
+    static thread_local int id = next++;
+    return id;
+}
+
+
+Profiler::Profiler() {
+    mOrigin = SDL_GetPerformanceCounter();
+}
+
+Profiler& Profiler::get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Phase& Profiler::phase(const char* name) {
+    for (Phase& p : mPhases) {
+        if (p.name == name || strcmp(p.name, name) == 0) {
+            return p;
+        }
+    }
+    Phase p;
+    p.name = name;
+    p.frameSeconds = 0;
+    p.history.assign(PROFILE_HISTORY, 0.0f);
+    p.next = 0;
+    p.count = 0;
+    mPhases.push_back(p);
+    return mPhases.back();
+}
+
+void Profiler::record(const char* name, Uint64 start, Uint64 end) {
+    const double seconds = (double)(end - start) / SDL_GetPerformanceFrequency();
+    std::lock_guard<std::mutex> guard(mLock);
+    phase(name).frameSeconds += seconds;
+    if (mTracing && mTrace.size() < PROFILE_MAX_EVENTS) {
+        mTrace.push_back({ name, threadId(), start, end });
+    }
+}
+
+void Profiler::endFrame() {
+    std::lock_guard<std::mutex> guard(mLock);
+    for (Phase& p : mPhases) {
+        p.history[p.next] = (float)(p.frameSeconds * 1000.0);
+        p.next = (p.next + 1) % PROFILE_HISTORY;
+        if (p.count < PROFILE_HISTORY) p.count++;
+        p.frameSeconds = 0;
+    }
+}
+
+void Profiler::startTrace(std::string path) {
+    std::lock_guard<std::mutex> guard(mLock);
+    mTracePath = path;
+    mTrace.clear();
+    mTracing = true;
+}
+
+bool Profiler::stopTrace() {
+    std::lock_guard<std::mutex> guard(mLock);
+    if (!mTracing) {
+        return false;
+    }
+    mTracing = false;
+    FILE* file = fopen(mTracePath.c_str(), "w");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Unable to write trace %s\n", mTracePath.c_str());
+        return false;
+    }
+    // complete ("X") events, timestamps in microseconds
+    const double to_us = 1e6 / SDL_GetPerformanceFrequency();
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (size_t i = 0; i < mTrace.size(); i++) {
+        const TraceEvent& e = mTrace[i];
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                e.name, e.thread, (e.start - mOrigin) * to_us, (e.end - e.start) * to_us,
+                i + 1 < mTrace.size() ? "," : "");
+    }
+    fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(file);
+    mTrace.clear();
+    return true;
+}
+
+float Profiler::percentile(const char* name, float p) {
+    std::lock_guard<std::mutex> guard(mLock);
+    Phase& ph = phase(name);
+    if (ph.count == 0) {
+        return 0;
+    }
+    std::vector<float> samples(ph.history.begin(), ph.history.begin() + ph.count);
+    const size_t k = std::min(samples.size() - 1, (size_t)(p / 100.0f * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+void Profiler::drawOverlay(SDL_Renderer* renderer, int x, int y) {
+    static const SDL_Color palette[] = {
+        { 230, 25, 75, 255 }, { 60, 180, 75, 255 }, { 0, 130, 200, 255 },
+        { 245, 130, 48, 255 }, { 145, 30, 180, 255 }, { 70, 240, 240, 255 }
+    };
+    // 200 px = one 60 Hz frame
+    const float px_per_ms = 200.0f / 16.667f;
+    const int bar_h = 8;
+    std::lock_guard<std::mutex> guard(mLock);
+
+    SDL_Rect background = { x, y, 216, (int)mPhases.size() * (bar_h + 4) + 8 };
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+    SDL_RenderFillRect(renderer, &background);
+    for (size_t i = 0; i < mPhases.size(); i++) {
+        const Phase& p = mPhases[i];
+        const float last = p.history[(p.next + PROFILE_HISTORY - 1) % PROFILE_HISTORY];
+        const SDL_Color c = palette[i % (sizeof(palette) / sizeof(palette[0]))];
+        const int top = y + 4 + (int)i * (bar_h + 4);
+        SDL_Rect bar = { x + 8, top, std::min(200, (int)(last * px_per_ms) + 1), bar_h };
+        SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+        SDL_RenderFillRect(renderer, &bar);
+        // white tick at the worst recent frame
+        float worst = 0;
+        for (int f = 0; f < p.count; f++) {
+            worst = std::max(worst, p.history[f]);
+        }
+        const int tick = x + 8 + std::min(200, (int)(worst * px_per_ms));
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderDrawLine(renderer, tick, top, tick, top + bar_h - 1);
+    }
+}
+
+void Profiler::printSummary() {
+    std::vector<const char*> names;
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        for (Phase& p : mPhases) {
+            names.push_back(p.name);
+        }
+    }
+    for (const char* name : names) {
+        fprintf(stderr, "%-12s p50 %8.3f ms   p99 %8.3f ms\n", name, percentile(name, 50), percentile(name, 99));
+    }
+}
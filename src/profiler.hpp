@@ -0,0 +1,74 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+
+// Per-phase frame timing.
+// PROFILE_SCOPE("update") times the rest of the enclosing block and adds
+// it to that phase's total for the frame; PROFILE_FRAME() closes the frame
+// and pushes every phase total into its history (for p50/p99). Scopes can
+// also be recorded as Chrome trace events (chrome://tracing, Perfetto).
+//
+// Scopes only exist when built with -DNOC_PROFILE (make CONFIG=profile);
+// otherwise the macros expand to nothing and cost nothing.
+class Profiler {
+    private:
+        struct Phase {
+            const char* name;
+            double frameSeconds; // accumulated this frame (summed over threads)
+            std::vector<float> history; // ms per frame, ring buffer
+            int next;
+            int count;
+        };
+        struct TraceEvent {
+            const char* name;
+            int thread;
+            Uint64 start;
+            Uint64 end;
+        };
+        std::mutex mLock;
+        std::vector<Phase> mPhases;
+        std::vector<TraceEvent> mTrace;
+        std::string mTracePath;
+        bool mTracing = false;
+        bool mOverlay = false;
+        Uint64 mOrigin;
+        Profiler();
+        Phase& phase(const char* name);
+    public:
+        static Profiler& get();
+        void record(const char* name, Uint64 start, Uint64 end);
+        void endFrame();
+        // collect trace events until stopTrace(), which writes them as json
+        void startTrace(std::string path);
+        bool stopTrace();
+        // bar chart of the last frame per phase, drawn by Loop before present
+        void setOverlay(bool overlay) { mOverlay = overlay; };
+        bool overlay() { return mOverlay; }
+        void drawOverlay(SDL_Renderer* renderer, int x = 8, int y = 8);
+        // ms per frame at percentile p (0-100) over the recent history
+        float percentile(const char* name, float p);
+        void printSummary();
+};
+
+class ProfileScope {
+    private:
+        const char* mName;
+        Uint64 mStart;
+    public:
+        ProfileScope(const char* name) : mName(name), mStart(SDL_GetPerformanceCounter()) {};
+        ~ProfileScope() { Profiler::get().record(mName, mStart, SDL_GetPerformanceCounter()); };
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#ifdef NOC_PROFILE
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define PROFILE_FRAME() Profiler::get().endFrame()
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#endif
@@ -0,0 +1,91 @@
+#include <SDL2/SDL.h>
+#include "random.hpp"
+
+
+Uint64 splitmix64(Uint64& state) {
+    Uint64 z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+
+// RNG
+Rng::Rng(Uint64 seed) {
+    // xoshiro must not start from all zeros; splitmix never gives four
+    Uint64 state = seed;
+    for (int i = 0; i < 4; i++) {
+        mState[i] = splitmix64(state);
+    }
+}
+
+Uint32 Rng::below(Uint32 n) {
+    // Lemire's multiply-shift with rejection of the biased sliver
+    Uint64 m = (Uint64)nextU32() * n;
+    Uint32 low = (Uint32)m;
+    if (low < n) {
+        const Uint32 threshold = (0u - n) % n;
+        while (low < threshold) {
+            m = (Uint64)nextU32() * n;
+            low = (Uint32)m;
+        }
+    }
+    return (Uint32)(m >> 32);
+}
+
+void Rng::jump() {
+    static const Uint64 JUMP[] = {
+        0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull,
+        0xa9582618e03fc9aaull, 0x39abdc4529b1661cull
+    };
+    Uint64 s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (JUMP[i] & (1ull << b)) {
+                s0 ^= mState[0];
+                s1 ^= mState[1];
+                s2 ^= mState[2];
+                s3 ^= mState[3];
+            }
+            next();
+        }
+    }
+    mState[0] = s0;
+    mState[1] = s1;
+    mState[2] = s2;
+    mState[3] = s3;
+}
+
+Rng Rng::split() {
+    Rng child = *this;
+    jump();
+    return child;
+}
+
+
+// DIRECTIONS
+const int DIRECTIONS4[4][2] = {
+    { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }
+};
+const int DIRECTIONS8[8][2] = {
+    { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+    { 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 }
+};
+
+void fillDirections(Rng& rng, int neighbors, int* dx, int* dy, int n) {
+    const int (*table)[2] = neighbors == 8 ? DIRECTIONS8 : DIRECTIONS4;
+    const int bits = neighbors == 8 ? 3 : 2;
+    const int per_draw = 64 / bits;
+    const Uint64 mask = (1u << bits) - 1;
+    int i = 0;
+    while (i < n) {
+        Uint64 r = rng.next();
+        const int end = (n - i < per_draw) ? n : i + per_draw;
+        for (; i < end; i++) {
+            const int choice = (int)(r & mask);
+            r >>= bits;
+            dx[i] = table[choice][0];
+            dy[i] = table[choice][1];
+        }
+    }
+}
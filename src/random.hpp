@@ -0,0 +1,49 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+
+// splitmix64 - turns a seed (or any counter) into well mixed 64 bit values
+Uint64 splitmix64(Uint64& state);
+
+// xoshiro256** (https://prng.di.unimi.it/)
+// - 32 bytes of state, a handful of ops per call, and the same sequence on
+//   every platform for a given seed (unlike rand())
+// - give each walker/thread its own generator: use split() to carve
+//   non-overlapping streams out of one seeded master
+class Rng {
+    private:
+        Uint64 mState[4];
+        static Uint64 rotl(Uint64 x, int k) { return (x << k) | (x >> (64 - k)); }
+    public:
+        Rng(Uint64 seed = 0);
+        Uint64 next() {
+            const Uint64 result = rotl(mState[1] * 5, 7) * 9;
+            const Uint64 t = mState[1] << 17;
+            mState[2] ^= mState[0];
+            mState[3] ^= mState[1];
+            mState[1] ^= mState[2];
+            mState[0] ^= mState[3];
+            mState[2] ^= t;
+            mState[3] = rotl(mState[3], 45);
+            return result;
+        }
+        Uint32 nextU32() { return (Uint32)(next() >> 32); }
+        // uniform integer in [0, n)
+        Uint32 below(Uint32 n);
+        // uniform float in [0, 1)
+        float uniform() { return (float)(next() >> 40) * (1.0f / (1 << 24)); }
+        // advance 2^128 steps
+        void jump();
+        // hand out a copy of this generator and jump past it, so the copy's
+        // next 2^128 values never overlap ours
+        Rng split();
+};
+
+// unit steps in the order RandomWalker::step / step8 pick them
+extern const int DIRECTIONS4[4][2];
+extern const int DIRECTIONS8[8][2];
+
+// fill dx/dy with n random unit steps from the 4 or 8 neighbor table
+// - draws 2 or 3 bits per step, so one next() call covers 32 or 21 steps
+void fillDirections(Rng& rng, int neighbors, int* dx, int* dy, int n);
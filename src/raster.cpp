@@ -0,0 +1,274 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "raster.hpp"
+#include "profiler.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RASTER_X86 1
+#define RASTER_AVX2_FN __attribute__((target("avx2")))
+#endif
+
+
+// color (unpacked from its DrawList key) and blend mode of one command
+struct Paint {
+    unsigned r;
+    unsigned g;
+    unsigned b;
+    unsigned a;
+    SDL_BlendMode blend;
+};
+
+static Paint paintOf(Uint64 key, SDL_BlendMode blend) {
+    const Uint64 rgba = key >> 32;
+    return { (unsigned)(rgba >> 24) & 0xFF, (unsigned)(rgba >> 16) & 0xFF,
+             (unsigned)(rgba >> 8) & 0xFF, (unsigned)rgba & 0xFF, blend };
+}
+
+// x / 255 without a division, exact for x <= 255 * 255
+static inline unsigned div255(unsigned x) {
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+// n pixels of one row, with the software renderer's per-channel formulas
+// (e.g. BLEND: d = d * (255 - a) / 255 + s * a / 255, alpha d * (255 - a) / 255 + a);
+// each loop is branch-free over the span, so it vectorizes
+__attribute__((always_inline))
+static inline void spanImpl(Uint32* __restrict dst, int n, const Paint& paint) {
+    // copies, so the loops don't reload them through dst
+    const unsigned a = paint.a;
+    const unsigned r = paint.r;
+    const unsigned g = paint.g;
+    const unsigned b = paint.b;
+    if (paint.blend == SDL_BLENDMODE_BLEND && a < 255) {
+        if (a == 0) {
+            return;
+        }
+        const unsigned inv = 255 - a;
+        const unsigned sr = div255(r * a), sg = div255(g * a), sb = div255(b * a);
+        for (int i = 0; i < n; i++) {
+            const Uint32 d = dst[i];
+            const unsigned dr = div255(((d >> 16) & 0xFF) * inv) + sr;
+            const unsigned dg = div255(((d >> 8) & 0xFF) * inv) + sg;
+            const unsigned db = div255((d & 0xFF) * inv) + sb;
+            const unsigned da = div255((d >> 24) * inv) + a;
+            dst[i] = (da << 24) | (dr << 16) | (dg << 8) | db;
+        }
+    } else if (paint.blend == SDL_BLENDMODE_ADD) {
+        const unsigned sr = div255(r * a), sg = div255(g * a), sb = div255(b * a);
+        for (int i = 0; i < n; i++) {
+            const Uint32 d = dst[i];
+            const unsigned dr = std::min(((d >> 16) & 0xFF) + sr, 255u);
+            const unsigned dg = std::min(((d >> 8) & 0xFF) + sg, 255u);
+            const unsigned db = std::min((d & 0xFF) + sb, 255u);
+            dst[i] = (d & 0xFF000000) | (dr << 16) | (dg << 8) | db;
+        }
+    } else if (paint.blend == SDL_BLENDMODE_MOD) {
+        for (int i = 0; i < n; i++) {
+            const Uint32 d = dst[i];
+            const unsigned dr = div255(((d >> 16) & 0xFF) * r);
+            const unsigned dg = div255(((d >> 8) & 0xFF) * g);
+            const unsigned db = div255((d & 0xFF) * b);
+            dst[i] = (d & 0xFF000000) | (dr << 16) | (dg << 8) | db;
+        }
+    } else {
+        // NONE, or opaque BLEND: the color as is
+        const Uint32 color = (a << 24) | (r << 16) | (g << 8) | b;
+        for (int i = 0; i < n; i++) {
+            dst[i] = color;
+        }
+    }
+}
+
+typedef void (*SpanFn)(Uint32* dst, int n, const Paint& paint);
+
+static void spanGeneric(Uint32* dst, int n, const Paint& paint) {
+    spanImpl(dst, n, paint);
+}
+
+#ifdef RASTER_X86
+RASTER_AVX2_FN static void spanAVX2(Uint32* dst, int n, const Paint& paint) {
+    spanImpl(dst, n, paint);
+}
+#endif
+
+static SpanFn bestSpan() {
+#ifdef RASTER_X86
+    static const SpanFn best = SDL_HasAVX2() ? spanAVX2 : spanGeneric;
+    return best;
+#else
+    return spanGeneric;
+#endif
+}
+
+// the part of [x, x + w) x [y, y + h) inside clip, row by row
+static void fillRect(int x, int y, int w, int h, const SDL_Rect& clip, Uint8* pixels, int pitch,
+                     const Paint& paint, SpanFn span) {
+    const int x0 = std::max(x, clip.x);
+    const int y0 = std::max(y, clip.y);
+    const int x1 = std::min(x + w, clip.x + clip.w);
+    const int y1 = std::min(y + h, clip.y + clip.h);
+    for (int row = y0; row < y1; row++) {
+        if (x0 < x1) {
+            span((Uint32*)(pixels + row * pitch) + x0, x1 - x0, paint);
+        }
+    }
+}
+
+// the tiles a command's bounds touch (inclusive), false if none
+static bool tileRange(const SDL_Rect& bounds, int width, int height, int tile_size,
+                      int& tx0, int& ty0, int& tx1, int& ty1) {
+    const int x0 = std::max(bounds.x, 0);
+    const int y0 = std::max(bounds.y, 0);
+    const int x1 = std::min(bounds.x + bounds.w, width);
+    const int y1 = std::min(bounds.y + bounds.h, height);
+    if (x0 >= x1 || y0 >= y1) {
+        return false;
+    }
+    tx0 = x0 / tile_size;
+    ty0 = y0 / tile_size;
+    tx1 = (x1 - 1) / tile_size;
+    ty1 = (y1 - 1) / tile_size;
+    return true;
+}
+
+
+TileRasterizer::TileRasterizer(int tile_size) {
+    mTileSize = tile_size > 0 ? tile_size : 64;
+}
+
+void TileRasterizer::bin(DrawList& list, int width, int height) {
+    mColumns = (width + mTileSize - 1) / mTileSize;
+    mRows = (height + mTileSize - 1) / mTileSize;
+    const int tiles = mColumns * mRows;
+    const int commands = (int)list.mCommands.size();
+    int tx0, ty0, tx1, ty1;
+
+    // count per tile, then a prefix sum gives each tile's first slot
+    mBinStart.assign(tiles + 1, 0);
+    for (int i = 0; i < commands; i++) {
+        if (!tileRange(list.mCommands[i].bounds, width, height, mTileSize, tx0, ty0, tx1, ty1)) {
+            continue;
+        }
+        for (int ty = ty0; ty <= ty1; ty++) {
+            for (int tx = tx0; tx <= tx1; tx++) {
+                mBinStart[ty * mColumns + tx + 1]++;
+            }
+        }
+    }
+    for (int t = 0; t < tiles; t++) {
+        mBinStart[t + 1] += mBinStart[t];
+    }
+    // fill in record order
+    mBinned.resize(mBinStart[tiles]);
+    mBinNext.assign(mBinStart.begin(), mBinStart.end() - 1);
+    for (int i = 0; i < commands; i++) {
+        if (!tileRange(list.mCommands[i].bounds, width, height, mTileSize, tx0, ty0, tx1, ty1)) {
+            continue;
+        }
+        for (int ty = ty0; ty <= ty1; ty++) {
+            for (int tx = tx0; tx <= tx1; tx++) {
+                mBinned[mBinNext[ty * mColumns + tx]++] = i;
+            }
+        }
+    }
+    mLastBinned = mBinStart[tiles];
+}
+
+void TileRasterizer::drawTile(DrawList& list, int tile, Uint32* pixels, int width, int height, int pitch) {
+    const int x = (tile % mColumns) * mTileSize;
+    const int y = (tile / mColumns) * mTileSize;
+    const SDL_Rect clip = { x, y, std::min(mTileSize, width - x), std::min(mTileSize, height - y) };
+    Uint8* bytes = (Uint8*)pixels;
+    const SpanFn span = bestSpan();
+
+    for (int k = mBinStart[tile]; k < mBinStart[tile + 1]; k++) {
+        const DrawList::Command& command = list.mCommands[mBinned[k]];
+        const Paint paint = paintOf(command.key, command.blend);
+        const DrawPrimitive primitive = (DrawPrimitive)(command.key & 0xFF);
+        if (primitive == DRAW_POINTS) {
+            const SDL_Point* points = &list.mPoints[command.first];
+            for (int i = 0; i < command.count; i++) {
+                const SDL_Point p = points[i];
+                if (p.x >= clip.x && p.y >= clip.y && p.x < clip.x + clip.w && p.y < clip.y + clip.h) {
+                    span((Uint32*)(bytes + p.y * pitch) + p.x, 1, paint);
+                }
+            }
+        } else if (primitive == DRAW_FILL_RECTS) {
+            const SDL_Rect* rects = &list.mRects[command.first];
+            for (int i = 0; i < command.count; i++) {
+                const SDL_Rect& r = rects[i];
+                fillRect(r.x, r.y, r.w, r.h, clip, bytes, pitch, paint, span);
+            }
+        } else {
+            // outlines as SDL_RenderDrawRect draws them: the top and bottom
+            // rows, then the sides between them, so no pixel is blended twice
+            const SDL_Rect* rects = &list.mRects[command.first];
+            for (int i = 0; i < command.count; i++) {
+                const SDL_Rect& r = rects[i];
+                if (r.w <= 0 || r.h <= 0) {
+                    continue;
+                }
+                fillRect(r.x, r.y, r.w, 1, clip, bytes, pitch, paint, span);
+                if (r.h > 1) {
+                    fillRect(r.x, r.y + r.h - 1, r.w, 1, clip, bytes, pitch, paint, span);
+                }
+                if (r.h > 2) {
+                    fillRect(r.x, r.y + 1, 1, r.h - 2, clip, bytes, pitch, paint, span);
+                    if (r.w > 1) {
+                        fillRect(r.x + r.w - 1, r.y + 1, 1, r.h - 2, clip, bytes, pitch, paint, span);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void TileRasterizer::drawTiles(DrawList& list, Uint32* pixels, int width, int height, int pitch,
+                               JobSystem* jobs) {
+    PROFILE_SCOPE("raster");
+    bin(list, width, height);
+    const int tiles = mColumns * mRows;
+    if (jobs == NULL) {
+        for (int t = 0; t < tiles; t++) {
+            drawTile(list, t, pixels, width, height, pitch);
+        }
+    } else {
+        // small chunks, since tiles differ a lot in how much they hold
+        const int grain = std::max(1, tiles / (jobs->threadCount() * 8));
+        jobs->parallelFor(0, tiles, grain, [&](int begin, int end) {
+            for (int t = begin; t < end; t++) {
+                drawTile(list, t, pixels, width, height, pitch);
+            }
+        });
+    }
+    list.clear();
+}
+
+void TileRasterizer::draw(DrawList& list, Uint32* pixels, int width, int height, int pitch) {
+    drawTiles(list, pixels, width, height, pitch, NULL);
+}
+
+void TileRasterizer::draw(DrawList& list, Uint32* pixels, int width, int height, int pitch,
+                          JobSystem& jobs) {
+    drawTiles(list, pixels, width, height, pitch, &jobs);
+}
+
+bool TileRasterizer::draw(DrawList& list, SDL_Surface* target) {
+    if (target->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        printf("Error: Tile rasterizer needs an ARGB8888 target\n");
+        return false;
+    }
+    drawTiles(list, (Uint32*)target->pixels, target->w, target->h, target->pitch, NULL);
+    return true;
+}
+
+bool TileRasterizer::draw(DrawList& list, SDL_Surface* target, JobSystem& jobs) {
+    if (target->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        printf("Error: Tile rasterizer needs an ARGB8888 target\n");
+        return false;
+    }
+    drawTiles(list, (Uint32*)target->pixels, target->w, target->h, target->pitch, &jobs);
+    return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <SDL2/SDL.h>
+#include "drawlist.hpp"
+#include "jobs.hpp"
+
+
+// CPU rasterizer for a DrawList, for when the target is a CPU framebuffer
+// anyway (the headless window, a PixelCanvas): instead of one software
+// renderer call per batch on one thread, the target is cut into square
+// tiles, every command is binned into the tiles its bounds touch, and the
+// tiles are rasterized independently, on different threads when given a
+// JobSystem. Within a tile commands run in record order, and spans are
+// blended with the software renderer's integer formulas, so the picture
+// is the same pixel for pixel as flush() to the headless renderer.
+// Blend modes are NONE, BLEND, ADD and MOD; anything else (e.g. a
+// composed custom mode) is drawn as NONE.
+class TileRasterizer {
+    private:
+        int mTileSize;
+        int mColumns = 0;
+        int mRows = 0;
+        // command indices grouped by tile: tile t owns
+        // mBinned[mBinStart[t] .. mBinStart[t + 1]), in record order
+        std::vector<int> mBinStart;
+        std::vector<int> mBinned;
+        std::vector<int> mBinNext; // fill cursor per tile while binning
+        int mLastBinned = 0;
+        void bin(DrawList& list, int width, int height);
+        void drawTile(DrawList& list, int tile, Uint32* pixels, int width, int height, int pitch);
+        void drawTiles(DrawList& list, Uint32* pixels, int width, int height, int pitch, JobSystem* jobs);
+    public:
+        TileRasterizer(int tile_size = 64);
+        // rasterize everything recorded in the list into ARGB8888 pixels
+        // (pitch in bytes, like SDL_Surface) and clear the list
+        void draw(DrawList& list, Uint32* pixels, int width, int height, int pitch);
+        void draw(DrawList& list, Uint32* pixels, int width, int height, int pitch, JobSystem& jobs);
+        // the same into a surface such as SDLWindow::getSurface(); false
+        // (and the list kept) if it isn't ARGB8888
+        bool draw(DrawList& list, SDL_Surface* target);
+        bool draw(DrawList& list, SDL_Surface* target, JobSystem& jobs);
+        int tileSize() { return mTileSize; }
+        // (command, tile) pairs binned by the last draw
+        int lastBinned() { return mLastBinned; }
+};
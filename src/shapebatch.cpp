@@ -0,0 +1,129 @@
+#include <SDL2/SDL.h>
+#include <limits.h>
+#include <vector>
+#include "shapebatch.hpp"
+#include "profiler.hpp"
+
+
+static bool sameColor(SDL_Color a, SDL_Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+void ShapeBatch::reserve(int circles, int rectangles, int points) {
+    mCircles.reserve(circles);
+    mRectangles.reserve(rectangles);
+    mPoints.reserve(points);
+}
+
+void ShapeBatch::clear() {
+    mCircles.clear();
+    mRectangles.clear();
+    mPoints.clear();
+}
+
+// each loop below gathers a run of shapes with the same color (and fill)
+// into one primitive buffer, then submits it with one call
+
+void ShapeBatch::drawAll(SDL_Renderer* renderer, std::vector<Circle>& circles) {
+    const int n = (int)circles.size();
+    int i = 0;
+    while (i < n) {
+        const SDL_Color c = circles[i].color();
+        const bool fill = circles[i].filled();
+        mRects.clear();
+        mPixels.clear();
+        int end = i;
+        while (end < n && sameColor(circles[end].color(), c) && circles[end].filled() == fill) {
+            const SDL_Point p = circles[end].pixel();
+            if (fill) {
+                circleSpans(p.x, p.y, circles[end].radius(), mRects);
+            } else {
+                circleOutline(p.x, p.y, circles[end].radius(), mPixels);
+            }
+            end++;
+        }
+        SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+        if (fill) {
+            SDL_RenderFillRects(renderer, mRects.data(), (int)mRects.size());
+        } else {
+            SDL_RenderDrawPoints(renderer, mPixels.data(), (int)mPixels.size());
+        }
+        mLastDrawCalls++;
+        i = end;
+    }
+}
+
+void ShapeBatch::drawAll(SDL_Renderer* renderer, std::vector<Rectangle>& rectangles) {
+    const int n = (int)rectangles.size();
+    int i = 0;
+    while (i < n) {
+        const SDL_Color c = rectangles[i].color();
+        const bool fill = rectangles[i].filled();
+        mRects.clear();
+        int end = i;
+        while (end < n && sameColor(rectangles[end].color(), c) && rectangles[end].filled() == fill) {
+            const SDL_Point p = rectangles[end].pixel();
+            mRects.push_back({ p.x, p.y, rectangles[end].width(), rectangles[end].height() });
+            end++;
+        }
+        SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+        if (fill) {
+            SDL_RenderFillRects(renderer, mRects.data(), (int)mRects.size());
+        } else {
+            SDL_RenderDrawRects(renderer, mRects.data(), (int)mRects.size());
+        }
+        mLastDrawCalls++;
+        i = end;
+    }
+}
+
+void ShapeBatch::drawAll(SDL_Renderer* renderer, std::vector<Point>& points) {
+    const int n = (int)points.size();
+    int i = 0;
+    while (i < n) {
+        const SDL_Color c = points[i].color();
+        mPixels.clear();
+        int end = i;
+        while (end < n && sameColor(points[end].color(), c)) {
+            mPixels.push_back(points[end].pixel());
+            end++;
+        }
+        SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+        SDL_RenderDrawPoints(renderer, mPixels.data(), (int)mPixels.size());
+        mLastDrawCalls++;
+        i = end;
+    }
+}
+
+void ShapeBatch::draw(SDL_Renderer* renderer) {
+    PROFILE_SCOPE("shape batch");
+    mLastDrawCalls = 0;
+    drawAll(renderer, mCircles);
+    drawAll(renderer, mRectangles);
+    drawAll(renderer, mPoints);
+}
+
+// grows [x0, x1) x [y0, y1) to cover the shapes; the qualified call is a
+// direct (inlined) call to T's bounds(), whatever the optimizer can prove
+// (the classes aren't final: RandomWalker derives from Circle)
+template <typename T>
+static void growBounds(std::vector<T>& shapes, int& x0, int& y0, int& x1, int& y1) {
+    for (T& shape : shapes) {
+        const SDL_Rect b = shape.T::bounds();
+        x0 = b.x < x0 ? b.x : x0;
+        y0 = b.y < y0 ? b.y : y0;
+        x1 = b.x + b.w > x1 ? b.x + b.w : x1;
+        y1 = b.y + b.h > y1 ? b.y + b.h : y1;
+    }
+}
+
+SDL_Rect ShapeBatch::bounds() {
+    int x0 = INT_MAX, y0 = INT_MAX, x1 = INT_MIN, y1 = INT_MIN;
+    growBounds(mCircles, x0, y0, x1, y1);
+    growBounds(mRectangles, x0, y0, x1, y1);
+    growBounds(mPoints, x0, y0, x1, y1);
+    if (x0 >= x1 || y0 >= y1) {
+        return { 0, 0, 0, 0 };
+    }
+    return { x0, y0, x1 - x0, y1 - y0 };
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <SDL2/SDL.h>
+#include "utils.hpp"
+
+
+// Shapes kept by concrete type instead of behind Polygon pointers, so
+// drawing them is one plain loop per type (no virtual call per shape,
+// nothing in the way of inlining) and each run of same-colored shapes
+// goes to SDL as one call. Circles are drawn first, then rectangles,
+// then points, each in the order they were added: use it where shapes of
+// different types don't overlap or their stacking doesn't matter, and
+// the virtual Polygon::draw where it does.
+class ShapeBatch {
+    private:
+        std::vector<Circle> mCircles;
+        std::vector<Rectangle> mRectangles;
+        std::vector<Point> mPoints;
+        // draw scratch, reused between frames
+        std::vector<SDL_Rect> mRects;
+        std::vector<SDL_Point> mPixels;
+        int mLastDrawCalls = 0;
+        void drawAll(SDL_Renderer* renderer, std::vector<Circle>& circles);
+        void drawAll(SDL_Renderer* renderer, std::vector<Rectangle>& rectangles);
+        void drawAll(SDL_Renderer* renderer, std::vector<Point>& points);
+    public:
+        ShapeBatch() {};
+        // overloads pick the bucket at compile time
+        void add(const Circle& circle) { mCircles.push_back(circle); }
+        void add(const Rectangle& rectangle) { mRectangles.push_back(rectangle); }
+        void add(const Point& point) { mPoints.push_back(point); }
+        std::vector<Circle>& circles() { return mCircles; }
+        std::vector<Rectangle>& rectangles() { return mRectangles; }
+        std::vector<Point>& points() { return mPoints; }
+        int size() { return (int)(mCircles.size() + mRectangles.size() + mPoints.size()); }
+        void reserve(int circles, int rectangles, int points);
+        void clear();
+        void draw(SDL_Renderer* renderer);
+        // the box around every shape (e.g. for a DamageTracker), empty if none
+        SDL_Rect bounds();
+        // SDL draw calls made by the last draw()
+        int lastDrawCalls() { return mLastDrawCalls; }
+};
@@ -0,0 +1,165 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <vector>
+#include "sprites.hpp"
+#include "utils.hpp"
+
+
+SpriteCache::SpriteCache(SDL_Renderer* renderer, long budget) {
+    mRenderer = renderer;
+    mBudget = budget;
+}
+
+SpriteCache::~SpriteCache() {
+    clear();
+}
+
+void SpriteCache::clear() {
+    for (auto& entry : mSprites) {
+        SDL_DestroyTexture(entry.second.texture);
+    }
+    mSprites.clear();
+    mLru.clear();
+    mBytes = 0;
+}
+
+void SpriteCache::setBudget(long budget) {
+    mBudget = budget;
+    evict(0);
+}
+
+// drop least recently used sprites until the new one fits
+void SpriteCache::evict(long needed) {
+    while (!mLru.empty() && mBytes + needed > mBudget) {
+        auto found = mSprites.find(mLru.back());
+        SDL_DestroyTexture(found->second.texture);
+        mBytes -= found->second.bytes;
+        mSprites.erase(found);
+        mLru.pop_back();
+        mEvictions++;
+    }
+}
+
+SpriteCache::Sprite* SpriteCache::create(Uint32 key, int radius, bool fill) {
+    const int size = 2 * radius + 1;
+    const long bytes = spriteBytes(radius);
+    evict(bytes);
+
+    // same pixels Circle::draw covers, white on transparent so color mod picks the color
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (surface == NULL) {
+        printf("Error: Unable to create sprite surface, SDL_Error: %s\n", SDL_GetError());
+        return NULL;
+    }
+    SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, 0xFF, 0xFF, 0xFF, 0));
+    const Uint32 white = SDL_MapRGBA(surface->format, 0xFF, 0xFF, 0xFF, 0xFF);
+    if (fill) {
+        std::vector<SDL_Rect> spans;
+        circleSpans(radius, radius, radius, spans);
+        SDL_FillRects(surface, spans.data(), (int)spans.size(), white);
+    } else {
+        std::vector<SDL_Point> points;
+        circleOutline(radius, radius, radius, points);
+        for (const SDL_Point& point : points) {
+            const SDL_Rect pixel = { point.x, point.y, 1, 1 };
+            SDL_FillRect(surface, &pixel, white);
+        }
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(mRenderer, surface);
+    SDL_FreeSurface(surface);
+    if (texture == NULL) {
+        printf("Error: Unable to create sprite texture, SDL_Error: %s\n", SDL_GetError());
+        return NULL;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    mLru.push_front(key);
+    Sprite& sprite = mSprites[key];
+    sprite = { texture, size, bytes, mLru.begin() };
+    mBytes += bytes;
+    return &sprite;
+}
+
+SDL_Texture* SpriteCache::circle(int radius, bool fill) {
+    if (radius <= 0 || spriteBytes(radius) > mBudget) {
+        return NULL;
+    }
+    const Uint32 key = ((Uint32)radius << 1) | (fill ? 1 : 0);
+    auto found = mSprites.find(key);
+    if (found != mSprites.end()) {
+        mHits++;
+        // move to the front of the LRU list
+        mLru.splice(mLru.begin(), mLru, found->second.lru);
+        return found->second.texture;
+    }
+    mMisses++;
+    Sprite* sprite = create(key, radius, fill);
+    return sprite != NULL ? sprite->texture : NULL;
+}
+
+void SpriteCache::drawCircle(int cx, int cy, int radius, SDL_Color color, bool fill) {
+    if (radius > 0 && spriteBytes(radius) > mBudget) {
+        // caching it would evict everything else and still not fit
+        Circle(cx, cy, radius, color, fill).draw(mRenderer);
+        return;
+    }
+    SDL_Texture* texture = circle(radius, fill);
+    if (texture == NULL) {
+        return;
+    }
+    const SDL_Rect quad = { cx - radius, cy - radius, 2 * radius + 1, 2 * radius + 1 };
+    SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(texture, color.a);
+    SDL_RenderCopy(mRenderer, texture, NULL, &quad);
+}
+
+void SpriteCache::drawCircles(const SDL_Point* centers, const SDL_Color* colors, int count,
+                              int radius, SDL_Color color, bool fill) {
+    if (radius > 0 && spriteBytes(radius) > mBudget) {
+        for (int i = 0; i < count; i++) {
+            drawCircle(centers[i].x, centers[i].y, radius, colors != NULL ? colors[i] : color, fill);
+        }
+        return;
+    }
+    SDL_Texture* texture = circle(radius, fill);
+    if (texture == NULL || count <= 0) {
+        return;
+    }
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    // one textured quad per circle, tinted through the vertex colors
+    SDL_SetTextureColorMod(texture, 0xFF, 0xFF, 0xFF);
+    SDL_SetTextureAlphaMod(texture, 0xFF);
+    const float size = (float)(2 * radius + 1);
+    mVertices.resize(count * 4);
+    mIndices.resize(count * 6);
+    for (int i = 0; i < count; i++) {
+        const float x = (float)(centers[i].x - radius);
+        const float y = (float)(centers[i].y - radius);
+        const SDL_Color c = colors != NULL ? colors[i] : color;
+        SDL_Vertex* v = &mVertices[i * 4];
+        v[0] = { { x, y }, c, { 0, 0 } };
+        v[1] = { { x + size, y }, c, { 1, 0 } };
+        v[2] = { { x + size, y + size }, c, { 1, 1 } };
+        v[3] = { { x, y + size }, c, { 0, 1 } };
+        int* index = &mIndices[i * 6];
+        index[0] = i * 4;
+        index[1] = i * 4 + 1;
+        index[2] = i * 4 + 2;
+        index[3] = i * 4;
+        index[4] = i * 4 + 2;
+        index[5] = i * 4 + 3;
+    }
+    SDL_RenderGeometry(mRenderer, texture, mVertices.data(), count * 4, mIndices.data(), count * 6);
+#else
+    for (int i = 0; i < count; i++) {
+        drawCircle(centers[i].x, centers[i].y, radius, colors != NULL ? colors[i] : color, fill);
+    }
+#endif
+}
+
+void SpriteCache::printStats() {
+    const long lookups = mHits + mMisses;
+    fprintf(stderr, "sprites: %d cached (%.1f KB of %.1f KB), %.1f%% hits, %ld evictions\n",
+            size(), mBytes / 1024.0, mBudget / 1024.0,
+            lookups > 0 ? 100.0 * mHits / lookups : 0.0, mEvictions);
+}
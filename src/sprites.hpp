@@ -0,0 +1,57 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <SDL2/SDL.h>
+
+
+// Circles rasterized once into white textures and then stamped with color
+// and alpha modulation (the LTexture setColor/setAlpha trick), instead of
+// running the midpoint loop for every circle every frame.
+// Textures belong to the renderer they were made with; call clear() after
+// SDL_RENDER_TARGETS_RESET or SDL_RENDER_DEVICE_RESET.
+// A circle whose texture alone is over the budget is never cached; it is
+// drawn with Circle::draw instead.
+class SpriteCache {
+    private:
+        struct Sprite {
+            SDL_Texture* texture;
+            int size;   // width and height, 2 * radius + 1
+            long bytes;
+            std::list<Uint32>::iterator lru;
+        };
+        SDL_Renderer* mRenderer;
+        long mBudget;
+        long mBytes = 0;
+        std::unordered_map<Uint32, Sprite> mSprites;
+        std::list<Uint32> mLru; // most recently used at the front
+        long mHits = 0;
+        long mMisses = 0;
+        long mEvictions = 0;
+        // batch scratch, reused between calls
+        std::vector<SDL_Vertex> mVertices;
+        std::vector<int> mIndices;
+        Sprite* create(Uint32 key, int radius, bool fill);
+        static long spriteBytes(int radius) { return (long)(2 * radius + 1) * (2 * radius + 1) * 4; }
+        void evict(long needed);
+    public:
+        // budget is the most texture memory (in bytes) kept alive at once
+        SpriteCache(SDL_Renderer* renderer, long budget = 8 << 20);
+        ~SpriteCache();
+        // the texture for a circle, created on first use, NULL on failure
+        // or if it is bigger than the whole budget
+        SDL_Texture* circle(int radius, bool fill);
+        void drawCircle(int cx, int cy, int radius, SDL_Color color, bool fill);
+        // same-sized circles in one SDL_RenderGeometry call (SDL 2.0.18+),
+        // colors may be NULL to draw them all in color
+        void drawCircles(const SDL_Point* centers, const SDL_Color* colors, int count,
+                         int radius, SDL_Color color, bool fill);
+        // destroy every texture
+        void clear();
+        void setBudget(long budget);
+        long bytes() { return mBytes; }
+        int size() { return (int)mSprites.size(); }
+        // hit rate and memory use, to stderr
+        void printStats();
+};
@@ -0,0 +1,139 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include "trails.hpp"
+#include "profiler.hpp"
+
+
+TrailBuffer::TrailBuffer() {
+    mRenderer = NULL;
+    mTexture = NULL;
+    mPrevTarget = NULL;
+    mWidth = 0;
+    mHeight = 0;
+    mBackground = { 0xFF, 0xFF, 0xFF, 0xFF };
+}
+
+TrailBuffer::~TrailBuffer() {
+    close();
+}
+
+SDL_Texture* TrailBuffer::createTexture(int width, int height) {
+    SDL_Texture* texture = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_ARGB8888,
+                                             SDL_TEXTUREACCESS_TARGET, width, height);
+    if (texture == NULL) {
+        printf("Error: Unable to create trail buffer, SDL_Error: %s\n", SDL_GetError());
+        return NULL;
+    }
+    // the buffer is opaque, so copying it simply replaces the window contents
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+    return texture;
+}
+
+bool TrailBuffer::init(SDL_Renderer* renderer, int width, int height, SDL_Color background) {
+    close();
+    mRenderer = renderer;
+    mBackground = background;
+    mTexture = createTexture(width, height);
+    if (mTexture == NULL) {
+        return false;
+    }
+    mWidth = width;
+    mHeight = height;
+    clear();
+    return true;
+}
+
+void TrailBuffer::close() {
+    if (mTexture != NULL) {
+        SDL_DestroyTexture(mTexture);
+    }
+    mTexture = NULL;
+    mWidth = 0;
+    mHeight = 0;
+}
+
+bool TrailBuffer::resize(int width, int height) {
+    if (width == mWidth && height == mHeight) {
+        return true;
+    }
+    SDL_Texture* texture = createTexture(width, height);
+    if (texture == NULL) {
+        return false;
+    }
+    SDL_Texture* old = mTexture;
+    const SDL_Rect kept = { 0, 0, width < mWidth ? width : mWidth, height < mHeight ? height : mHeight };
+    mTexture = texture;
+    mWidth = width;
+    mHeight = height;
+    clear();
+    if (old != NULL) {
+        SDL_Texture* target = SDL_GetRenderTarget(mRenderer);
+        SDL_SetRenderTarget(mRenderer, mTexture);
+        SDL_RenderCopy(mRenderer, old, &kept, &kept);
+        SDL_SetRenderTarget(mRenderer, target);
+        SDL_DestroyTexture(old);
+    }
+    return true;
+}
+
+void TrailBuffer::clear() {
+    if (mTexture == NULL) {
+        return;
+    }
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(mRenderer, &r, &g, &b, &a);
+    SDL_Texture* target = SDL_GetRenderTarget(mRenderer);
+    SDL_SetRenderTarget(mRenderer, mTexture);
+    SDL_SetRenderDrawColor(mRenderer, mBackground.r, mBackground.g, mBackground.b, 0xFF);
+    SDL_RenderClear(mRenderer);
+    SDL_SetRenderTarget(mRenderer, target);
+    SDL_SetRenderDrawColor(mRenderer, r, g, b, a);
+}
+
+void TrailBuffer::begin() {
+    mPrevTarget = SDL_GetRenderTarget(mRenderer);
+    SDL_SetRenderTarget(mRenderer, mTexture);
+    if (mFade > 0) {
+        PROFILE_SCOPE("trail fade");
+        Uint8 r, g, b, a;
+        SDL_BlendMode blend;
+        SDL_GetRenderDrawColor(mRenderer, &r, &g, &b, &a);
+        SDL_GetRenderDrawBlendMode(mRenderer, &blend);
+        SDL_SetRenderDrawBlendMode(mRenderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(mRenderer, mBackground.r, mBackground.g, mBackground.b, mFade);
+        SDL_RenderFillRect(mRenderer, NULL);
+        SDL_SetRenderDrawColor(mRenderer, r, g, b, a);
+        SDL_SetRenderDrawBlendMode(mRenderer, blend);
+    }
+}
+
+void TrailBuffer::end() {
+    SDL_SetRenderTarget(mRenderer, mPrevTarget);
+    mPrevTarget = NULL;
+}
+
+void TrailBuffer::present() {
+    if (mTexture != NULL) {
+        SDL_RenderCopy(mRenderer, mTexture, NULL, NULL);
+    }
+}
+
+bool TrailBuffer::handleEvent(const SDL_Event& event) {
+    if (event.type == SDL_RENDER_DEVICE_RESET) {
+        // every texture has to be recreated
+        init(mRenderer, mWidth, mHeight, mBackground);
+        return true;
+    }
+    if (event.type == SDL_RENDER_TARGETS_RESET) {
+        // the texture survives but its contents don't
+        clear();
+        return true;
+    }
+    if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+        int width, height;
+        SDL_GetRendererOutputSize(mRenderer, &width, &height);
+        resize(width, height);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+
+// Offscreen render target that keeps everything drawn into it between
+// frames, so sketches that paint trails can still clear the window every
+// frame instead of relying on the backbuffer surviving SDL_RenderPresent.
+// Each frame: begin(), draw only what's new, end(), then present() copies
+// the whole buffer to the window in one SDL_RenderCopy.
+class TrailBuffer {
+    private:
+        SDL_Renderer* mRenderer;
+        SDL_Texture* mTexture;
+        SDL_Texture* mPrevTarget;
+        int mWidth;
+        int mHeight;
+        SDL_Color mBackground;
+        Uint8 mFade = 0;
+        SDL_Texture* createTexture(int width, int height);
+    public:
+        TrailBuffer();
+        ~TrailBuffer();
+        bool init(SDL_Renderer* renderer, int width, int height, SDL_Color background);
+        void close();
+        // grow or shrink, keeping the trails in the top left corner
+        bool resize(int width, int height);
+        // alpha of the background laid over the trails every begin(),
+        // 0 keeps them forever, 255 clears every frame (8-bit blending
+        // leaves faint ghosts behind for small fades)
+        void setFade(Uint8 fade) { mFade = fade; };
+        // fade, then send drawing into the buffer
+        void begin();
+        // send drawing back to whatever the target was before begin()
+        void end();
+        // one copy of the buffer onto the current target
+        void present();
+        // wipe the trails to the background
+        void clear();
+        // recreates or clears the buffer after render resets and resizes,
+        // returns true if the event was one of those
+        bool handleEvent(const SDL_Event& event);
+        int width() { return mWidth; }
+        int height() { return mHeight; }
+};
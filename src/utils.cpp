@@ -1,23 +1,49 @@
 #include <SDL2/SDL.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string>
+#include <vector>
 #include "utils.hpp"
+#include "drawlist.hpp"
 
 SDLWindow::SDLWindow() {
-    SDL_Window* mWindow = NULL;
-    SDL_Renderer* mRenderer = NULL;
-    int mWidth = 0;
-    int mHeight = 0;
+    mWindow = NULL;
+    mRenderer = NULL;
+    mSurface = NULL;
+    mBackend = BACKEND_WINDOW;
+    mWidth = 0;
+    mHeight = 0;
 }
 
 SDLWindow::~SDLWindow() {
     close();
 }
 
-bool SDLWindow::init(int width, int height) {
+bool SDLWindow::init(int width, int height, bool vsync, RenderBackend backend) {
     bool success = true;
     mWidth = width;
     mHeight = height;
+    mBackend = backend;
+    if (backend == BACKEND_HEADLESS) {
+        // events only (for SDL_QUIT etc.) - no video subsystem, no display
+        if ( SDL_Init(SDL_INIT_EVENTS) < 0 ) {
+            printf("Error: SDL could not initialize, SDL_Error: %s\n", SDL_GetError());
+            return false;
+        }
+        mSurface = SDL_CreateRGBSurfaceWithFormat(0, mWidth, mHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (mSurface == NULL) {
+            printf("Error: Framebuffer could not be created, SDL_Error: %s\n", SDL_GetError());
+            return false;
+        }
+        mRenderer = SDL_CreateSoftwareRenderer(mSurface);
+        if (mRenderer == NULL) {
+            printf("Error: Renderer could not be created, SDL_Error: %s\n", SDL_GetError());
+            return false;
+        }
+        SDL_SetRenderDrawColor(mRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+        SDL_SetRenderDrawBlendMode(mRenderer, SDL_BLENDMODE_BLEND);
+        return true;
+    }
     if ( SDL_Init(SDL_INIT_VIDEO) < 0 ) {
         printf("Error: SDL could not initialize, SDL_Error: %s\n", SDL_GetError());
         success = false;
@@ -31,8 +57,12 @@ bool SDLWindow::init(int width, int height) {
             printf("Error: Window could not be created, SDL_Error: %s\n", SDL_GetError()); 
             success = false;
         } else {
-            // create renderer (vsynced)
-            mRenderer = SDL_CreateRenderer(mWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+            // create renderer (vsynced unless asked otherwise)
+            Uint32 flags = SDL_RENDERER_ACCELERATED;
+            if (vsync) {
+                flags |= SDL_RENDERER_PRESENTVSYNC;
+            }
+            mRenderer = SDL_CreateRenderer(mWindow, -1, flags);
             if (mRenderer == NULL) {
                 printf("Error: Renderer could not be created, SDL_Error: %s\n", SDL_GetError());
                 success = false;
@@ -47,11 +77,19 @@ bool SDLWindow::init(int width, int height) {
 }
 
 void SDLWindow::close() {
-    // destroy renderer & window
-    SDL_DestroyRenderer(mRenderer);
-    SDL_DestroyWindow(mWindow);
+    // destroy renderer & window (or framebuffer)
+    if (mRenderer != NULL) {
+        SDL_DestroyRenderer(mRenderer);
+    }
+    if (mWindow != NULL) {
+        SDL_DestroyWindow(mWindow);
+    }
+    if (mSurface != NULL) {
+        SDL_FreeSurface(mSurface);
+    }
     mRenderer = NULL;
     mWindow = NULL;
+    mSurface = NULL;
     // quit SDL subsystems
     SDL_Quit();
 }
@@ -60,6 +98,22 @@ SDL_Renderer* SDLWindow::getRenderer() {
     return mRenderer;
 }
 
+SDL_Surface* SDLWindow::getSurface() {
+    return mSurface;
+}
+
+bool SDLWindow::saveFrame(std::string path) {
+    if (mSurface == NULL) {
+        fprintf(stderr, "Error: Only headless frames can be saved\n");
+        return false;
+    }
+    if (SDL_SaveBMP(mSurface, path.c_str()) < 0) {
+        fprintf(stderr, "Error: Unable to save frame to %s, SDL_Error: %s\n", path.c_str(), SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
 int SDLWindow::width() {
     return mWidth;
 }
@@ -69,32 +123,118 @@ int SDLWindow::height() {
 }
 
 
+// SKETCH OPTIONS
+bool parseSketchOptions(int argc, char* args[], SketchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = args[i];
+        if (arg == "--headless") {
+            options.headless = true;
+            options.uncapped = true;
+        } else if (arg == "--uncapped") {
+            options.uncapped = true;
+        } else if (arg == "--frames" && i + 1 < argc) {
+            options.frames = atol(args[++i]);
+        } else if (arg == "--save" && i + 1 < argc) {
+            options.savePath = args[++i];
+        } else if (arg == "--capture" && i + 1 < argc) {
+            options.capturePath = args[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            options.tracePath = args[++i];
+        } else if (arg == "--overlay") {
+            options.overlay = true;
+        } else if (arg == "--dirty") {
+            options.dirty = true;
+        } else {
+            printf("Usage: %s [--headless] [--uncapped] [--frames N] [--save file.bmp] [--capture path]"
+                   " [--trace file.json] [--overlay] [--dirty]\n", args[0]);
+            return false;
+        }
+    }
+#ifndef NOC_PROFILE
+    if (!options.tracePath.empty() || options.overlay) {
+        fprintf(stderr, "Warning: built without NOC_PROFILE (make CONFIG=profile), nothing will be timed\n");
+    }
+#endif
+    if (options.headless && options.frames == 0) {
+        options.frames = 600;
+    }
+    return true;
+}
+
+
 // CIRCLE
-void Circle::draw(SDL_Renderer* renderer) {
-    const int diameter = (mRadius * 2);
-    int x = (mRadius - 1);
+void circleSpans(int cx, int cy, int radius, std::vector<SDL_Rect>& spans) {
+    // widest span seen for each row offset from the center
+    static thread_local std::vector<int> halfWidths;
+    halfWidths.assign(radius > 0 ? radius : 0, -1);
+
+    const int diameter = (radius * 2);
+    int x = (radius - 1);
     int y = 0;
     int tx = 1;
     int ty = 1;
     int error = (tx - diameter);
 
-    SDL_SetRenderDrawColor(renderer, mColor.r, mColor.g, mColor.b, mColor.a);
     while (x >= y) {
+        // the octants overlap, so only keep the widest span per row
+        if (x > halfWidths[y]) halfWidths[y] = x;
+        if (y > halfWidths[x]) halfWidths[x] = y;
+
+        if (error <= 0) {
+            ++y;
+            error += ty;
+            ty += 2;
+        }
+        if (error > 0) {
+            --x;
+            tx += 2;
+            error += (tx - diameter);
+        }
+    }
+    // emit rows top to bottom, center row once
+    for (int dy = radius - 1; dy > 0; dy--) {
+        const int hw = halfWidths[dy];
+        if (hw >= 0) spans.push_back({ cx - hw, cy - dy, 2 * hw + 1, 1 });
+    }
+    for (int dy = 0; dy < radius; dy++) {
+        const int hw = halfWidths[dy];
+        if (hw >= 0) spans.push_back({ cx - hw, cy + dy, 2 * hw + 1, 1 });
+    }
+}
+
+void circleOutline(int cx, int cy, int radius, std::vector<SDL_Point>& points) {
+    const int diameter = (radius * 2);
+    int x = (radius - 1);
+    int y = 0;
+    int tx = 1;
+    int ty = 1;
+    int error = (tx - diameter);
 
-        if (mFillFlag) {
-            SDL_RenderDrawLine(renderer, mX + x, mY + y, mX - x, mY + y);
-            SDL_RenderDrawLine(renderer, mX + x, mY - y, mX - x, mY - y);
-            SDL_RenderDrawLine(renderer, mX + y, mY + x, mX - y, mY + x);
-            SDL_RenderDrawLine(renderer, mX + y, mY - x, mX - y, mY - x);
+    while (x >= y) {
+        if (x == 0) {
+            // single pixel circle
+            points.push_back({ cx, cy });
+        } else if (y == 0) {
+            // axis points - the mirrored pairs coincide
+            points.push_back({ cx + x, cy });
+            points.push_back({ cx - x, cy });
+            points.push_back({ cx, cy + x });
+            points.push_back({ cx, cy - x });
+        } else if (x == y) {
+            // diagonal points - the octant swap gives the same pixel
+            points.push_back({ cx + x, cy - y });
+            points.push_back({ cx + x, cy + y });
+            points.push_back({ cx - x, cy - y });
+            points.push_back({ cx - x, cy + y });
         } else {
-            SDL_RenderDrawPoint(renderer, mX + x, mY - y);
-            SDL_RenderDrawPoint(renderer, mX + x, mY + y);
-            SDL_RenderDrawPoint(renderer, mX - x, mY - y);
-            SDL_RenderDrawPoint(renderer, mX - x, mY + y);
-            SDL_RenderDrawPoint(renderer, mX + y, mY - x);
-            SDL_RenderDrawPoint(renderer, mX + y, mY + x);
-            SDL_RenderDrawPoint(renderer, mX - y, mY - x);
-            SDL_RenderDrawPoint(renderer, mX - y, mY + x);
+            points.push_back({ cx + x, cy - y });
+            points.push_back({ cx + x, cy + y });
+            points.push_back({ cx - x, cy - y });
+            points.push_back({ cx - x, cy + y });
+            points.push_back({ cx + y, cy - x });
+            points.push_back({ cx + y, cy + x });
+            points.push_back({ cx - y, cy - x });
+            points.push_back({ cx - y, cy + x });
         }
 
         if (error <= 0) {
@@ -110,10 +250,34 @@ void Circle::draw(SDL_Renderer* renderer) {
     }
 }
 
+void Circle::draw(SDL_Renderer* renderer) {
+    // scratch buffers are reused between calls so drawing doesn't allocate
+    static std::vector<SDL_Rect> spans;
+    static std::vector<SDL_Point> points;
+
+    const SDL_Point p = pixel();
+    SDL_SetRenderDrawColor(renderer, mColor.r, mColor.g, mColor.b, mColor.a);
+    if (mFillFlag) {
+        spans.clear();
+        circleSpans(p.x, p.y, mRadius, spans);
+        SDL_RenderFillRects(renderer, spans.data(), (int)spans.size());
+    } else {
+        points.clear();
+        circleOutline(p.x, p.y, mRadius, points);
+        SDL_RenderDrawPoints(renderer, points.data(), (int)points.size());
+    }
+}
+
+void Circle::record(DrawList& list) {
+    const SDL_Point p = pixel();
+    list.circle(mColor, p.x, p.y, mRadius, mFillFlag);
+}
+
 
 // RECTANGLE
 void Rectangle::draw(SDL_Renderer *renderer) {
-    SDL_Rect fillRect = { mX, mY, mWidth, mHeight };
+    const SDL_Point p = pixel();
+    SDL_Rect fillRect = { p.x, p.y, mWidth, mHeight };
     SDL_SetRenderDrawColor(renderer, mColor.r, mColor.g, mColor.b, mColor.a);
     if (mFillFlag) {
         SDL_RenderFillRect(renderer, &fillRect);
@@ -122,9 +286,20 @@ void Rectangle::draw(SDL_Renderer *renderer) {
     }
 }
 
+void Rectangle::record(DrawList& list) {
+    const SDL_Point p = pixel();
+    list.rect(mColor, { p.x, p.y, mWidth, mHeight }, mFillFlag);
+}
+
 
 // POINT
 void Point::draw(SDL_Renderer *renderer) {
     SDL_SetRenderDrawColor(renderer, mColor.r, mColor.g, mColor.b, mColor.a);
-    SDL_RenderDrawPoint(renderer, mX, mY);
+    const SDL_Point p = pixel();
+    SDL_RenderDrawPoint(renderer, p.x, p.y);
+}
+
+void Point::record(DrawList& list) {
+    const SDL_Point p = pixel();
+    list.point(mColor, p.x, p.y);
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <SDL2/SDL.h>
+#include "vec2.hpp"
 
 #define SDL_COL_BLACK {0, 0, 0, 255}
 #define SDL_COL_WHITE {255, 255, 255, 255}
@@ -9,52 +11,107 @@
 #define SDL_COL_GREEN {0, 255, 0, 255}
 #define SDL_COL_BLUE {0, 0, 255, 255}
 
+class DrawList;
+
+
+// rasterize a midpoint circle into a buffer (appends, doesn't clear)
+// - every covered pixel is emitted exactly once, so blended colors don't
+//   double up where the octants meet
+void circleSpans(int cx, int cy, int radius, std::vector<SDL_Rect>& spans);
+void circleOutline(int cx, int cy, int radius, std::vector<SDL_Point>& points);
+// the square both of them stay inside
+inline SDL_Rect circleBounds(int cx, int cy, int radius) {
+    return { cx - (radius - 1), cy - (radius - 1), 2 * radius - 1, 2 * radius - 1 };
+}
+
+
+// where SDLWindow draws to
+enum RenderBackend {
+    BACKEND_WINDOW,  // visible window with an accelerated renderer
+    BACKEND_HEADLESS // CPU framebuffer via SDL's software renderer, no display needed
+};
 
 class SDLWindow {
     private:
         SDL_Window* mWindow;
         SDL_Renderer* mRenderer;
+        SDL_Surface* mSurface; // headless framebuffer
+        RenderBackend mBackend;
         int mWidth;
         int mHeight;
     public:
         SDLWindow();
         ~SDLWindow();
-        bool init(int width, int height);
+        // vsync only applies to BACKEND_WINDOW; headless never waits
+        bool init(int width, int height, bool vsync = true, RenderBackend backend = BACKEND_WINDOW);
         void close();
         SDL_Renderer* getRenderer();
+        // the framebuffer when headless, NULL otherwise
+        SDL_Surface* getSurface();
+        bool isHeadless() { return mBackend == BACKEND_HEADLESS; }
+        // write the current framebuffer as a BMP (headless only)
+        bool saveFrame(std::string path);
         int width();
         int height();
 };
 
+// command line switches shared by the sketches
+struct SketchOptions {
+    bool headless = false; // --headless: render into a CPU framebuffer (implies --uncapped)
+    bool uncapped = false; // --uncapped: no vsync, one tick per frame
+    long frames = 0;       // --frames N: stop after N frames (headless default 600)
+    std::string savePath;  // --save file.bmp: write the last headless frame
+    std::string capturePath; // --capture out.y4m|out.rgba|out.ppm|-|"|cmd": record every frame
+    std::string tracePath; // --trace file.json: chrome trace of profiled scopes (NOC_PROFILE builds)
+    bool overlay = false;  // --overlay: per-phase timing bars on screen (NOC_PROFILE builds)
+    bool dirty = false;    // --dirty: redraw only what changed (sketches that support it)
+};
+// returns false (after printing usage) on a bad argument
+bool parseSketchOptions(int argc, char* args[], SketchOptions& options);
+
+// positions are sub-pixel floats, rounded only when rasterized
 class Polygon {
     protected:
-        int mX;
-        int mY;
+        float mX;
+        float mY;
         SDL_Color mColor;
         bool mFillFlag = false;
     public:
-        Polygon(int x, int y, SDL_Color color, bool fill) :
+        Polygon(float x, float y, SDL_Color color, bool fill) :
             mX(x), mY(y), mColor(color), mFillFlag(fill) {};
-        Polygon(int x, int y, SDL_Color color) :
+        Polygon(float x, float y, SDL_Color color) :
             mX(x), mY(y), mColor(color) {};
-        int x() { return mX; }
-        int y() { return mY; }
-        void move(int x, int y) { mX = x; mY = y; };
+        virtual ~Polygon() {};
+        float x() { return mX; }
+        float y() { return mY; }
+        Vec2 position() { return Vec2(mX, mY); }
+        // the pixel the position rounds to
+        SDL_Point pixel() { return { (int)lrintf(mX), (int)lrintf(mY) }; }
+        SDL_Color color() { return mColor; }
+        bool filled() { return mFillFlag; }
+        void move(float x, float y) { mX = x; mY = y; };
+        void move(Vec2 position) { mX = position.x; mY = position.y; };
         void setColor(SDL_Color color) { mColor = color; };
         void setFill(bool fill) { mFillFlag = fill; };
         virtual void draw(SDL_Renderer* renderer) = 0;
+        // queue the shape in a draw list instead of drawing it now
+        virtual void record(DrawList& list) = 0;
+        // the pixels draw() can touch, for damage tracking
+        virtual SDL_Rect bounds() = 0;
 };
 
 class Circle: public Polygon {
     private:
         int mRadius;
     public:
-        Circle(int x, int y, int radius, SDL_Color color, bool fill) :
+        Circle(float x, float y, int radius, SDL_Color color, bool fill) :
             Polygon(x, y, color, fill), mRadius(radius) {};
-        Circle(int x, int y, int radius, SDL_Color color) :
+        Circle(float x, float y, int radius, SDL_Color color) :
             Polygon(x, y, color), mRadius(radius) {};
         int radius() { return mRadius; }
         void draw(SDL_Renderer* renderer);
+        void record(DrawList& list);
+        SDL_Rect bounds() { return circleBounds(pixel().x, pixel().y, mRadius); }
 };
 
 class Rectangle: public Polygon {
@@ -62,18 +119,22 @@ class Rectangle: public Polygon {
         int mWidth;
         int mHeight;
     public:
-        Rectangle(int x, int y, int width, int height, SDL_Color color, bool fill) :
+        Rectangle(float x, float y, int width, int height, SDL_Color color, bool fill) :
             Polygon(x, y, color, fill), mWidth(width), mHeight(height) {};
-        Rectangle(int x, int y, int width, int height, SDL_Color color) :
+        Rectangle(float x, float y, int width, int height, SDL_Color color) :
             Polygon(x, y, color), mWidth(width), mHeight(height) {};
         int width() { return mWidth; }
         int height() { return mHeight; }
         void draw(SDL_Renderer* renderer);
+        void record(DrawList& list);
+        SDL_Rect bounds() { return { pixel().x, pixel().y, mWidth, mHeight }; }
 };
 
 class Point: public Polygon {
     public:
-        Point(int x, int y, SDL_Color color) :
+        Point(float x, float y, SDL_Color color) :
             Polygon(x, y, color) {};
         void draw(SDL_Renderer* renderer);
+        void record(DrawList& list);
+        SDL_Rect bounds() { return { pixel().x, pixel().y, 1, 1 }; }
 };
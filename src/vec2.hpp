@@ -0,0 +1,132 @@
+#pragma once
+
+#include <math.h>
+#include <limits>
+#include <type_traits>
+
+
+inline float map(float value, float in_min, float in_max, float out_min, float out_max) {
+    return (value - in_min) / (in_max - in_min) * (out_max - out_min) + out_min;
+}
+
+inline float lerp(float alpha, float a, float b) {
+    // (1 - alpha)*a + alpha*b
+    return a + alpha * (b - a);
+}
+
+
+// 2D vector (PVector in the book). Just two packed components, so an array
+// of them is an array of floats that loops can vectorize over.
+template <typename T>
+struct Vec2T {
+    T x;
+    T y;
+
+    constexpr Vec2T() : x(0), y(0) {}
+    constexpr Vec2T(T x_, T y_) : x(x_), y(y_) {}
+
+    constexpr Vec2T operator+(const Vec2T& v) const { return Vec2T(x + v.x, y + v.y); }
+    constexpr Vec2T operator-(const Vec2T& v) const { return Vec2T(x - v.x, y - v.y); }
+    constexpr Vec2T operator*(T s) const { return Vec2T(x * s, y * s); }
+    constexpr Vec2T operator/(T s) const { return Vec2T(x / s, y / s); }
+    constexpr Vec2T operator-() const { return Vec2T(-x, -y); }
+    constexpr bool operator==(const Vec2T& v) const { return x == v.x && y == v.y; }
+    constexpr bool operator!=(const Vec2T& v) const { return !(*this == v); }
+    Vec2T& operator+=(const Vec2T& v) { x += v.x; y += v.y; return *this; }
+    Vec2T& operator-=(const Vec2T& v) { x -= v.x; y -= v.y; return *this; }
+    Vec2T& operator*=(T s) { x *= s; y *= s; return *this; }
+    Vec2T& operator/=(T s) { x /= s; y /= s; return *this; }
+
+    constexpr T dot(const Vec2T& v) const { return x * v.x + y * v.y; }
+    // z of the 3D cross product, positive when v is counterclockwise of this
+    constexpr T cross(const Vec2T& v) const { return x * v.y - y * v.x; }
+    constexpr T lengthSq() const { return x * x + y * y; }
+    T length() const { return sqrt(lengthSq()); }
+    // angle from the +x axis in radians
+    T heading() const { return atan2(y, x); }
+    // unit length, or zero for the zero vector
+    Vec2T normalized() const {
+        const T len = length();
+        return len > 0 ? *this / len : Vec2T();
+    }
+    // scaled down to at most max length
+    Vec2T limited(T max) const {
+        const T len2 = lengthSq();
+        return len2 > max * max ? *this * (max / sqrt(len2)) : *this;
+    }
+    Vec2T withLength(T len) const { return normalized() * len; }
+    Vec2T rotated(T angle) const {
+        const T c = cos(angle);
+        const T s = sin(angle);
+        return Vec2T(x * c - y * s, x * s + y * c);
+    }
+    static Vec2T fromAngle(T angle, T len = 1) { return Vec2T(cos(angle) * len, sin(angle) * len); }
+};
+
+template <typename T>
+constexpr Vec2T<T> operator*(T s, const Vec2T<T>& v) { return v * s; }
+
+template <typename T>
+T dist(const Vec2T<T>& a, const Vec2T<T>& b) { return (b - a).length(); }
+
+template <typename T>
+constexpr Vec2T<T> lerp(T alpha, const Vec2T<T>& a, const Vec2T<T>& b) { return a + (b - a) * alpha; }
+
+typedef Vec2T<float> Vec2;
+typedef Vec2T<double> Vec2d;
+
+static_assert(sizeof(Vec2) == 2 * sizeof(float), "Vec2 must stay two packed floats");
+static_assert(std::is_trivially_copyable<Vec2>::value, "Vec2 must stay trivially copyable");
+
+
+// Batched operations over arrays of vectors, as flat loops over the
+// components: the element-wise ones (addScaled, scale) vectorize at -O2,
+// limit/normalize are branch-free but only vectorize at -O3.
+
+// v[i] += d[i] * s  (e.g. position += velocity * dt)
+template <typename T>
+inline void addScaled(Vec2T<T>* __restrict v, const Vec2T<T>* __restrict d, T s, int count) {
+    T* __restrict out = &v[0].x;
+    const T* __restrict in = &d[0].x;
+    for (int i = 0; i < 2 * count; i++) {
+        out[i] += in[i] * s;
+    }
+}
+
+// v[i] *= s
+template <typename T>
+inline void scale(Vec2T<T>* v, T s, int count) {
+    T* out = &v[0].x;
+    for (int i = 0; i < 2 * count; i++) {
+        out[i] *= s;
+    }
+}
+
+// v[i] = v[i].limited(max)
+template <typename T>
+inline void limit(Vec2T<T>* v, T max, int count) {
+    T* c = &v[0].x;
+    for (int i = 0; i < count; i++) {
+        const T len2 = c[2 * i] * c[2 * i] + c[2 * i + 1] * c[2 * i + 1];
+        // max / max(len, max): 1 when already short enough, and a select
+        // rather than fmax so it vectorizes
+        const T len = sqrt(len2);
+        const T s = max / (len > max ? len : max);
+        c[2 * i] *= s;
+        c[2 * i + 1] *= s;
+    }
+}
+
+// v[i] = v[i].normalized()
+template <typename T>
+inline void normalize(Vec2T<T>* v, int count) {
+    T* c = &v[0].x;
+    for (int i = 0; i < count; i++) {
+        const T len2 = c[2 * i] * c[2 * i] + c[2 * i + 1] * c[2 * i + 1];
+        // the zero vector stays zero: 0 times any finite scale
+        const T tiny = std::numeric_limits<T>::min();
+        const T s = T(1) / sqrt(len2 > tiny ? len2 : tiny);
+        c[2 * i] *= s;
+        c[2 * i + 1] *= s;
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <assert.h>
+#include "utils.hpp"
+#include "noise.hpp"
+#include "random.hpp"
+#include "flowfield.hpp"
+
+
+// how a walker moves each update()
+enum StepMode {
+    STEP_4,      // up, down, left, or right
+    STEP_8,      // ... or diagonally
+    STEP_PERLIN, // follow the noise field
+    STEP_FLOW    // drift along a baked FlowField (needs setFlow)
+};
+
+class RandomWalker: public Circle {
+    private:
+        const int mWindowHeight;
+        const int mWindowWidth;
+        Noise mNoise;
+        Rng mRng;
+        float tx = 0.01;
+        float ty = 1000;
+        StepMode mMode = STEP_4;
+        float mStepAmount = 1;
+        const FlowField* mFlow = NULL;
+    public:
+        RandomWalker(int x, int y, SDL_Color color, int window_height, int window_width,
+                     const Noise& noise, const Rng& rng) :
+            Circle(x, y, 2, color),
+            mWindowHeight(window_height),
+            mWindowWidth(window_width),
+            mNoise(noise),
+            mRng(rng)
+        {};
+        // step up, down, left, or right
+        void step(int magnitude = 1) {
+            const int* d = DIRECTIONS4[mRng.next() >> 62];
+            mX = mX + d[0] * magnitude;
+            mY = mY + d[1] * magnitude;
+        }
+        // step in any direction - up, down, left, right, and diagonals
+        void step8(int magnitude = 1) {
+            const int* d = DIRECTIONS8[mRng.next() >> 61];
+            mX = mX + d[0] * magnitude;
+            mY = mY + d[1] * magnitude;
+        }
+        void perlinStep(float step_size = 0.01) {
+            // sample both axes in one batch
+            const float coords[2] = { tx, ty };
+            float noise[2];
+            mNoise.sampleBatch(coords, NULL, NULL, noise, 2);
+            mX = map(noise[0], 0, 1, 0, mWindowWidth);
+            mY = map(noise[1], 0, 1, 0, mWindowHeight);
+            tx += step_size;
+            ty += step_size;
+            if (tx > 1e6) {
+                tx = 0.01;
+            }
+            if (ty > 1e6) {
+                ty = 1000;
+            }
+        }
+        // one lookup instead of sampling noise, wrapping at the window edges
+        void flowStep(float speed = 1) {
+            const Vec2 d = mFlow->lookup(mX, mY);
+            mX += d.x * speed;
+            mY += d.y * speed;
+            if (mX < 0) mX += mWindowWidth;
+            if (mX >= mWindowWidth) mX -= mWindowWidth;
+            if (mY < 0) mY += mWindowHeight;
+            if (mY >= mWindowHeight) mY -= mWindowHeight;
+        }
+        // the field STEP_FLOW follows (shared, not owned)
+        void setFlow(const FlowField* flow) { mFlow = flow; };
+        // pick how update() moves the walker (step magnitude or noise step size)
+        void setMode(StepMode mode, float amount) {
+            mMode = mode;
+            mStepAmount = amount;
+        }
+        void update() {
+            if (mMode == STEP_4) {
+                step((int)mStepAmount);
+            } else if (mMode == STEP_8) {
+                step8((int)mStepAmount);
+            } else if (mMode == STEP_FLOW) {
+                // no field is a bug in the sketch: debug builds stop here,
+                // release ones leave the walker standing still
+                assert(mFlow != NULL && "STEP_FLOW needs setFlow()");
+                if (mFlow != NULL) {
+                    flowStep(mStepAmount);
+                }
+            } else {
+                perlinStep(mStepAmount);
+            }
+        }
+};